@@ -0,0 +1,48 @@
+#ifndef ACCT
+#define ACCT
+
+/************************** ACCT.H *****************************
+*
+*  The externals declaration file for the phase 1 Accounting
+*    Module.
+*
+*  chargeCpu keeps p_time up to date in every build. Built with
+*    PHASE1_ACCT, every PCB is also stamped with the TOD when it
+*    enters a process queue, and the length of each stay is added
+*    to its p_wait when it leaves; the waits on each semaphore
+*    and on each ready queue level are also recorded 
+*    in a log2 histogram (waithist_t). Without PHASE1_ACCT the
+*    macros below expand to nothing.
+*
+*/
+
+#include "../h/types.h"
+
+#ifdef PHASE1_ACCT
+
+extern void 	acctEnqueue 	(pcb_PTR p);
+extern void 	acctDequeue 	(pcb_PTR p);
+
+/* Stamps P entering a queue */
+#define ACCT_ENQUEUE(P)		acctEnqueue(P)
+/* Closes P's stay in a queue; P->p_qtime is then its length */
+#define ACCT_DEQUEUE(P)		acctDequeue(P)
+/* Records the stay P just closed in histogram H */
+#define ACCT_RECORD(H, P)	recordHist((H), (P)->p_qtime)
+
+#else
+
+#define ACCT_ENQUEUE(P)		((void) 0)
+#define ACCT_DEQUEUE(P)		((void) 0)
+#define ACCT_RECORD(H, P)	((void) 0)
+
+#endif
+
+extern void 	chargeCpu 		(pcb_PTR p, cpu_t since);
+extern void 	resetHist 		(waithist_PTR h);
+extern void 	recordHist 		(waithist_PTR h, cpu_t wait);
+extern void 	dumpHist 		(char *name, waithist_PTR h, void (*print)(char *));
+
+/***************************************************************/
+
+#endif
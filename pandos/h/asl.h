@@ -10,12 +10,24 @@
 */
 
 #include "../h/types.h"
+#include "../h/link.h"
 
 extern int 		insertBlocked 	(int *semAdd, pcb_PTR p);
+extern int 		insertBlockedPrio (int *semAdd, pcb_PTR p);
 extern pcb_PTR 	removeBlocked 	(int *semAdd);
 extern pcb_PTR 	outBlocked 		(pcb_PTR p);
+extern pcb_PTR 	outBlockedUnchecked (pcb_PTR p);
+extern void 	setBlockedPrio 	(pcb_PTR p, int prio);
 extern pcb_PTR 	headBlocked 	(int *semAdd);
+extern pcb_PTR 	removeAllBlocked (int *semAdd);
 extern void 	initASL 		(void);
+extern void 	registerDevSems	(int devSems[]);
+#ifdef PHASE1_ACCT
+extern waithist_PTR semWaitHist	(int *semAdd);
+#endif
+#ifdef ASL_HYSTERESIS
+extern semdcache_t	semdCache;
+#endif
 
 /***************************************************************/
 
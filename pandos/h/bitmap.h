@@ -0,0 +1,18 @@
+#ifndef BITMAP
+#define BITMAP
+
+/************************* BITMAP.H ****************************
+*
+*  The externals declaration file for the bit manipulation 
+*    helpers shared by the phase 1 modules.
+*
+*/
+
+#include "../h/types.h"
+
+extern int 		firstSetBit 	(unsigned int w);
+extern int 		lastSetBit 		(unsigned int w);
+
+/***************************************************************/
+
+#endif
@@ -0,0 +1,36 @@
+#ifndef CHECK
+#define CHECK
+
+/************************** CHECK.H ****************************
+*
+*  Precondition checks of the unchecked tier of the phase 1
+*    modules.
+*
+*  The public functions of the PCB and ASL modules validate
+*    their arguments once and then call an ...Unchecked
+*    function, which trusted callers may also call directly.
+*    The unchecked functions state their preconditions with
+*    REQUIRE: built with PHASE1_DEBUG, a violated one panics
+*    the machine; otherwise REQUIRE expands to nothing and
+*    nothing is checked twice.
+*
+*/
+
+#include "../h/types.h"
+
+#ifdef PHASE1_DEBUG
+
+#include "../h/port.h"
+
+/* Panics unless condition C holds */
+#define REQUIRE(C)		((C) ? (void) 0 : PANIC())
+
+#else
+
+#define REQUIRE(C)		((void) 0)
+
+#endif
+
+/***************************************************************/
+
+#endif
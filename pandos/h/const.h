@@ -10,8 +10,94 @@
 /* Hardware & software constants */
 #define PAGESIZE		4096			/* page size in bytes */
 #define WORDLEN			4				/* word size in bytes */
-#define MAXPROC			20				/* max concurrent processes	*/
 #define MAX_INT			0x7FFFFFFF		/* max 32bit int value */
+#define MAXSEMADD		((int *) (~0UL >> 1))	/* above every semaphore address (ASL tail key) */
+
+/* pool sizes, normally set by the phase1 Makefile (MAXPROC=, MAXSEMD=) */
+#ifndef MAXPROC
+#define MAXPROC			20				/* max concurrent processes	*/
+#endif
+#ifndef MAXSEMD
+#define MAXSEMD			MAXPROC			/* semaphore descriptors in the ASL pool */
+#endif
+
+/* ASL backend: the sorted list only pays off for small pools, so larger 
+ * ones default to the hashed ASL unless ASL_LIST is given explicitly; 
+ * the multiprocessor configuration locks the ASL by bucket, so it 
+ * always uses the hashed ASL */
+#if !defined(ASL_LIST) && !defined(ASL_HASH) && (MAXSEMD > 32 || defined(PHASE1_SMP))
+#define ASL_HASH
+#endif
+
+/* multiprocessor configuration (PHASE1_SMP): processors, and the free 
+ * PCBs each one caches, refilled and drained PCBREFILL at a time */
+#ifndef NCPU
+#define NCPU			1
+#endif
+#define PCBCACHESIZE	8
+#define PCBREFILL		(PCBCACHESIZE / 2)
+#ifdef PHASE1_SMP
+#ifdef ASL_LIST
+#error "PHASE1_SMP locks the ASL by hash bucket: ASL_LIST is not supported"
+#endif
+#ifdef ASL_HYSTERESIS
+#error "PHASE1_SMP does not support ASL_HYSTERESIS (one LRU list across buckets)"
+#endif
+#endif
+
+/* hashed ASL backend (ASL_HASH), about one bucket per descriptor */
+#ifndef ASLHASHBITS
+#if MAXSEMD <= 32
+#define ASLHASHBITS		5				/* log2 of the number of ASL buckets */
+#elif MAXSEMD <= 128
+#define ASLHASHBITS		7
+#elif MAXSEMD <= 512
+#define ASLHASHBITS		9
+#elif MAXSEMD <= 2048
+#define ASLHASHBITS		11
+#else
+#define ASLHASHBITS		13
+#endif
+#endif
+#define ASLHASHSIZE		(1 << ASLHASHBITS)
+
+/* multi-level ready queue priorities (0 is the highest) */
+#define PRIOLEVELS		8				/* priority levels, at most 32 */
+#define HIGHPRIO		0
+#define LOWPRIO			(PRIOLEVELS - 1)
+#define DEFAULTPRIO		(PRIOLEVELS / 2)
+
+/* process handles: PCB index in the low PIDINDEXBITS bits, that PCB's 
+ * generation (odd while allocated) in the others; 0 is never valid */
+#define PIDINDEXBITS	16
+#define PIDINDEXMASK	((1U << PIDINDEXBITS) - 1)
+#define NOPROCID		0
+#if MAXPROC > (1 << PIDINDEXBITS)
+#error "MAXPROC does not fit in PIDINDEXBITS"
+#endif
+
+/* compact layout (LINK_INDEX): PCB and descriptor links are 16-bit pool 
+ * indexes, with NOLINK for no entry (see h/link.h) */
+#define NOLINK			0xFFFF
+#define SEMDPOOLSIZE	(MAXSEMD + DUMMYVARCOUNT + DEVSEMNUM)
+#if defined(LINK_INDEX) && (MAXPROC > NOLINK || SEMDPOOLSIZE > NOLINK)
+#error "pools do not fit in 16-bit links"
+#endif
+
+/* queue wait histograms (PHASE1_ACCT): bucket 0 counts waits of 0, 
+ * bucket b waits in [2^(b-1), 2^b) TOD units, the last one all longer */
+#define ACCTBUCKETS		16
+
+/* per-semaphore wait histograms (PHASE1_ACCT), kept by semaphore address 
+ * across descriptor reuse: about two slots per ASL bucket, and at most 
+ * SEMHISTPROBES probed before a semaphore falls back to the shared one */
+#define SEMHISTBITS		(ASLHASHBITS + 1)
+#define SEMHISTSIZE		(1 << SEMHISTBITS)
+#define SEMHISTPROBES	8
+
+/* timer events (see h/timer.h), in TOD clock units (microseconds) */
+#define TIMESLICE		5000			/* length of a scheduling quantum */
+#define PSECOND			100000			/* pseudo-clock tick period */
 
 /* timer, timescale, TOD-LO and other bus regs */
 #define RAMBASEADDR		0x10000000
@@ -39,6 +125,8 @@
 
 #define DEVINTNUM		  5		  /* interrupt lines used by devices */
 #define DEVPERINT		  8		  /* devices per interrupt line */
+#define DEVSEMNUM		((DEVINTNUM + 1) * DEVPERINT + 1)	/* device semaphores: terminals twice, plus the pseudo-clock */
+#define CLOCKSEM		(DEVSEMNUM - 1)	  /* index of the pseudo-clock among the device semaphores */
 #define DEVREGLEN		  4		  /* device register field length in bytes, and regs per dev */	
 #define DEVREGSIZE	  16 		/* device register size in bytes */
 
@@ -63,6 +151,12 @@
 #define RESET			    0
 #define ACK				    1
 
+/* terminal transmitter codes */
+#define TRANSMITTED		    5	  /* status: character transmitted */
+#define PRINTCHR		    2	  /* command: transmit the character */
+#define CHAROFFSET		    8	  /* bit position of the character in the command */
+#define STATUSMASK		    0xFF  /* status code bits of the status field */
+
 /* Memory related constants */
 #define KSEG0           0x00000000
 #define KSEG1           0x20000000
@@ -82,10 +176,16 @@
 #define MAX(A,B)		((A) < (B) ? B : A)
 #define	ALIGNED(A)		(((unsigned)A & 0x3) == 0)
 
+/* machine clock macros; a host build (PHASE1_HOST) gets them from port.h */
+#ifndef PHASE1_HOST
 /* Macro to load the Interval Timer */
 #define LDIT(T)	((* ((cpu_t *) INTERVALTMR)) = (T) * (* ((cpu_t *) TIMESCALEADDR))) 
 
+/* Macro to park the Interval Timer as far in the future as it goes */
+#define DISARMIT()	((* ((cpu_t *) INTERVALTMR)) = MAX_INT)
+
 /* Macro to read the TOD clock */
 #define STCK(T) ((T) = ((* ((cpu_t *) TODLOADDR)) / (* ((cpu_t *) TIMESCALEADDR))))
+#endif
 
 #endif
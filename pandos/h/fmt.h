@@ -0,0 +1,22 @@
+#ifndef FMT
+#define FMT
+
+/************************** FMT.H ******************************
+*
+*  The externals declaration file for the phase 1 text formatting
+*    helpers, defined in stats.c.
+*
+*  The dump functions (dumpStats, dumpHist, dumpTrace) and the
+*    test programs build their output lines in place, without a
+*    C library. Each helper writes at buf, adds no EOS, and
+*    returns a pointer to the character after what it wrote.
+*
+*/
+
+extern char *	fmtuint 		(char *buf, unsigned int v);
+extern char *	fmthex 			(char *buf, unsigned int v);
+extern char *	fmtstr 			(char *buf, char *str);
+
+/***************************************************************/
+
+#endif
@@ -0,0 +1,55 @@
+#ifndef LINK
+#define LINK
+
+/************************** LINK.H *****************************
+*
+*  The link accessors of the PCB and semaphore descriptor pools.
+*
+*  Every link field of pcb_t and semd_t (pcblink_t, semdlink_t)
+*    is read and written through these macros. By default a link
+*    is a plain pointer and they expand to the field itself.
+*    Built with LINK_INDEX, a link is the 16-bit index of its
+*    target in pcbPool or semdPool, NOLINK standing for NULL,
+*    and they convert between the two; the pcb_PTR and semd_PTR
+*    interfaces of the modules do not change.
+*
+*  Links may be copied and compared to NILLINK as they are. The
+*    conversion macros evaluate their argument more than once.
+*
+*/
+
+#include "../h/types.h"
+
+#ifdef LINK_INDEX
+
+extern pcb_t	pcbPool[];
+extern semd_t	semdPool[];
+
+#define NILLINK			NOLINK
+
+/* Link L as a pointer, and pointer P (never the NULL literal) as a link */
+#define PCBREF(L)		((NOLINK == (L)) ? (pcb_PTR) NULL : &pcbPool[L])
+#define PCBLINK(P)		((pcblink_t) ((NULL == (P)) ? NOLINK : (P) - pcbPool))
+#define SEMDREF(L)		((NOLINK == (L)) ? (semd_PTR) NULL : &semdPool[L])
+#define SEMDLINK(S)		((semdlink_t) ((NULL == (S)) ? NOLINK : (S) - semdPool))
+
+#else
+
+#define NILLINK			NULL
+
+#define PCBREF(L)		(L)
+#define PCBLINK(P)		(P)
+#define SEMDREF(L)		(L)
+#define SEMDLINK(S)		(S)
+
+#endif
+
+/* Field F of X, a PCB or descriptor link, read as a pointer or set to one */
+#define GETPCB(X, F)		PCBREF((X)->F)
+#define SETPCB(X, F, P)		((X)->F = PCBLINK(P))
+#define GETSEMD(X, F)		SEMDREF((X)->F)
+#define SETSEMD(X, F, S)	((X)->F = SEMDLINK(S))
+
+/***************************************************************/
+
+#endif
@@ -10,23 +10,43 @@
 */
 
 #include "../h/types.h"
+#include "../h/link.h"
 
 extern void 	freePcb 		(pcb_PTR p);
 extern pcb_PTR 	allocPcb 		(void);
 extern void 	initPcbs 		(void);
+extern int 		allocPcbBatch 	(pcb_PTR pcbs[], int n);
+extern void 	freePcbBatch 	(pcb_PTR pcbs[], int n);
+extern procid_t pcbToHandle 	(pcb_PTR p);
+extern pcb_PTR 	handleToPcb 	(procid_t pid);
 
 extern pcb_PTR 	mkEmptyProcQ	(void); 
 extern int 		emptyProcQ 		(pcb_PTR tp);
 extern void 	insertProcQ 	(pcb_PTR *tp, pcb_PTR p);
+extern void 	insertProcQUnchecked (pcb_PTR *tp, pcb_PTR p);
 
 extern pcb_PTR 	removeProcQ 	(pcb_PTR *tp);
 extern pcb_PTR 	outProcQ 		(pcb_PTR *tp, pcb_PTR p);
+extern pcb_PTR 	outProcQUnchecked (pcb_PTR *tp, pcb_PTR p);
 extern pcb_PTR 	headProcQ 		(pcb_PTR tp);
+extern void 	unblockProcQ 	(pcb_PTR *tp);
 
 extern int 		emptyChild 		(pcb_PTR p);
 extern void 	insertChild 	(pcb_PTR prnt, pcb_PTR p);
+extern void 	insertChildUnchecked (pcb_PTR prnt, pcb_PTR p);
 extern pcb_PTR 	removeChild 	(pcb_PTR p);
 extern pcb_PTR 	outChild 		(pcb_PTR p);
+extern pcb_PTR 	outChildUnchecked (pcb_PTR p);
+extern void 	adoptChildren 	(pcb_PTR prnt, pcb_PTR p);
+extern int 		childCount 		(pcb_PTR p);
+
+extern void 	walkSubtree 	(pcb_PTR root, pcbVisit_t visit, void *arg);
+extern void 	outSubtree 		(pcb_PTR root, pcbVisit_t visit, void *arg);
+
+extern pcb_PTR 	firstLive 		(void);
+extern pcb_PTR 	nextLive 		(pcb_PTR p);
+extern int 		liveCount 		(void);
+extern void 	walkLive 		(pcbVisit_t visit, void *arg);
 
 /***************************************************************/
 
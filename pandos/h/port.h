@@ -0,0 +1,58 @@
+#ifndef PORT
+#define PORT
+
+/************************** PORT.H *****************************
+*
+*  Target portability header of phase 1.
+*
+*  The default target is the uMPS3 machine, whose library 
+*    (libumps) is included here. Built with PHASE1_HOST, 
+*    the phase 1 modules and test programs run as an 
+*    ordinary host program instead (see the host targets 
+*    of the phase1 Makefile): the machine services they 
+*    use are replaced by the host shim of phase1/host.c.
+*
+*  The shim includes no phase 1 header, and so does not 
+*    clash with the NULL of const.h; the phase 1 code 
+*    includes no system header.
+*
+*/
+
+#include "../h/types.h"
+
+#ifdef PHASE1_HOST
+
+extern cpu_t	hostClock		(void);
+extern int		hostPrint		(char *str);
+extern void		hostPanic		(void);
+extern void		hostHalt		(void);
+extern unsigned int	hostCas		(unsigned int *atomic, unsigned int ov, unsigned int nv);
+extern int		hostCpu;
+
+/* TOD clock in microseconds, as the uMPS3 STCK */
+#define STCK(T)		((T) = hostClock())
+/* there is no interval timer on the host */
+#define LDIT(T)		((void) (T))
+#define DISARMIT()	((void) 0)
+#define PANIC()		hostPanic()
+#define HALT()		hostHalt()
+#define CAS(A, O, N)	hostCas((A), (O), (N))
+/* the host runs phase 1 on a single processor, which a test may 
+ * renumber (hostCpu) to stand in for the others */
+#define CPUID()		hostCpu
+
+/* the test program's main is called by the shim's */
+#define main		phase1Main
+
+#else
+
+#include "/usr/include/umps3/umps/libumps.h"
+
+/* number of the processor running the caller */
+#define CPUID()		((int) getPRID())
+
+#endif
+
+/***************************************************************/
+
+#endif
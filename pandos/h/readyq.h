@@ -0,0 +1,29 @@
+#ifndef READYQ
+#define READYQ
+
+/************************* READYQ.H ****************************
+*
+*  The externals declaration file for the Multi-Level Ready 
+*    Queue Module.
+*
+*/
+
+#include "../h/types.h"
+
+extern void 	initReadyQ 		(readyq_PTR rq);
+extern int 		emptyReadyQ 	(readyq_PTR rq);
+extern void 	insertReadyQ 	(readyq_PTR rq, pcb_PTR p);
+extern pcb_PTR 	removeReadyQ 	(readyq_PTR rq);
+extern pcb_PTR 	outReadyQ 		(readyq_PTR rq, pcb_PTR p);
+extern pcb_PTR 	headReadyQ 		(readyq_PTR rq);
+extern void 	setPriority 	(readyq_PTR rq, pcb_PTR p, int prio);
+extern pcb_PTR 	stealReadyQ 	(readyq_t rqs[], int ncpu, int self);
+
+#ifdef PHASE1_SMP
+extern readyq_t	cpuReadyQ[];
+extern pcb_PTR 	nextReady 		(void);
+#endif
+
+/***************************************************************/
+
+#endif
@@ -0,0 +1,23 @@
+#ifndef SLEEPQ
+#define SLEEPQ
+
+/************************* SLEEPQ.H ****************************
+*
+*  The externals declaration file for the Sleep Queue (delta 
+*    list) Module.
+*
+*/
+
+#include "../h/types.h"
+
+extern void 	initSleepQ 		(sleepq_PTR sq);
+extern int 		emptySleepQ 	(sleepq_PTR sq);
+extern void 	insertSleepQ 	(sleepq_PTR sq, pcb_PTR p, cpu_t delay);
+extern pcb_PTR 	outSleepQ 		(sleepq_PTR sq, pcb_PTR p);
+extern int 		wakeSleepQ 		(sleepq_PTR sq, pcb_PTR *tp);
+extern cpu_t 	nextWakeup 		(sleepq_PTR sq);
+extern void 	armSleepQ 		(sleepq_PTR sq);
+
+/***************************************************************/
+
+#endif
@@ -0,0 +1,38 @@
+#ifndef SPIN
+#define SPIN
+
+/************************** SPIN.H *****************************
+*
+*  The externals declaration file for the phase 1 Spinlock
+*    Module.
+*
+*  Built with PHASE1_SMP, the shared structures of the PCB, ASL
+*    and ready queue modules are guarded by spinlocks taken with
+*    the macros below. Without PHASE1_SMP the macros expand to
+*    nothing, and so do their arguments.
+*
+*/
+
+#include "../h/types.h"
+
+#ifdef PHASE1_SMP
+
+extern void 	initLock 		(spinlock_t *l);
+extern void 	spinLock 		(spinlock_t *l);
+extern void 	spinUnlock 		(spinlock_t *l);
+
+#define INITLOCK(L)		initLock(L)
+#define LOCK(L)			spinLock(L)
+#define UNLOCK(L)		spinUnlock(L)
+
+#else
+
+#define INITLOCK(L)		((void) 0)
+#define LOCK(L)			((void) 0)
+#define UNLOCK(L)		((void) 0)
+
+#endif
+
+/***************************************************************/
+
+#endif
@@ -0,0 +1,114 @@
+#ifndef STATS
+#define STATS
+
+/************************** STATS.H ****************************
+*
+*  The externals declaration file for the phase 1 Instrumentation
+*    Module.
+*
+*  Built with PHASE1_STATS, every operation of the PCB and ASL
+*    modules (and traverseASL) counts its calls, the loop
+*    iterations it performs (nodes visited) and the TOD time it
+*    takes. Without PHASE1_STATS the macros below expand to nothing
+*    and the modules carry no instrumentation at all.
+*
+*  STAT_ENTER closes each call through GCC's cleanup attribute, an
+*    extension that gcc also accepts under -ansi; a build with
+*    PHASE1_STATS therefore needs a GCC compatible compiler (both
+*    the uMPS3 cross compiler and the host one are).
+*
+*/
+
+#include "../h/types.h"
+
+/* instrumented operations */
+#define ST_INITPCBS			0
+#define ST_FREEPCB			1
+#define ST_ALLOCPCB			2
+#define ST_ALLOCPCBBATCH	3
+#define ST_FREEPCBBATCH		4
+#define ST_PCBTOHANDLE		5
+#define ST_HANDLETOPCB		6
+#define ST_MKEMPTYPROCQ		7
+#define ST_EMPTYPROCQ		8
+#define ST_INSERTPROCQ		9
+#define ST_REMOVEPROCQ		10
+#define ST_OUTPROCQ			11
+#define ST_HEADPROCQ		12
+#define ST_UNBLOCKPROCQ		13
+#define ST_EMPTYCHILD		14
+#define ST_INSERTCHILD		15
+#define ST_REMOVECHILD		16
+#define ST_OUTCHILD			17
+#define ST_ADOPTCHILDREN	18
+#define ST_CHILDCOUNT		19
+#define ST_WALKSUBTREE		20
+#define ST_OUTSUBTREE		21
+#define ST_FIRSTLIVE		22
+#define ST_NEXTLIVE			23
+#define ST_LIVECOUNT		24
+#define ST_WALKLIVE			25
+#define ST_TRAVERSEASL		26
+#define ST_INSERTBLOCKED	27
+#define ST_INSERTBLOCKEDPRIO	28
+#define ST_REMOVEBLOCKED	29
+#define ST_OUTBLOCKED		30
+#define ST_HEADBLOCKED		31
+#define ST_REMOVEALLBLOCKED	32
+#define ST_SETBLOCKEDPRIO	33
+#define ST_REGISTERDEVSEMS	34
+#define ST_INITASL			35
+#define STATOPS				36
+
+/* counters of one operation */
+typedef struct opstat_t {
+	unsigned int	os_calls;		/* number of calls */
+	unsigned int	os_iters;		/* loop iterations (nodes visited) */
+	cpu_t			os_ticks;		/* total TOD time spent in the calls */
+	cpu_t			os_maxTicks;	/* longest single call */
+} opstat_t;
+
+/* counters of all operations */
+typedef struct phase1stats_t {
+	opstat_t		st_op[STATOPS];
+} phase1stats_t;
+
+#ifdef PHASE1_STATS
+
+#ifndef __GNUC__
+#error "PHASE1_STATS needs the GCC cleanup attribute (see STAT_ENTER)"
+#endif
+
+/* running call of an operation, closed by statLeave when it goes out of scope */
+typedef struct statframe_t {
+	int				sf_op;			/* operation being timed */
+	cpu_t			sf_start;		/* TOD at entry */
+} statframe_t;
+
+extern phase1stats_t phase1Stats;
+
+extern statframe_t 	statEnter 		(int op);
+extern void 		statLeave 		(statframe_t *f);
+
+/* Opens the instrumented call of operation OP. Place it, without a 
+ * trailing semicolon, after the last declaration of the function: 
+ * the call is closed on every return path, by the cleanup attribute 
+ * (a GCC extension) running statLeave when statFrame leaves scope. */
+#define STAT_ENTER(OP)	statframe_t statFrame __attribute__((cleanup(statLeave))) = statEnter(OP);
+
+/* Counts one loop iteration of operation OP */
+#define STAT_ITER(OP)	(phase1Stats.st_op[OP].os_iters++)
+
+#else
+
+#define STAT_ENTER(OP)
+#define STAT_ITER(OP)	((void) 0)
+
+#endif
+
+extern void 	resetStats 		(void);
+extern void 	dumpStats 		(void (*print)(char *));
+
+/***************************************************************/
+
+#endif
@@ -0,0 +1,41 @@
+#ifndef TERMOUT
+#define TERMOUT
+
+/************************* TERMOUT.H ***************************
+*
+*  The externals declaration file for the Buffered Terminal
+*    Output Module.
+*
+*  Each terminal transmitter has a ring of TERMBUFSIZE
+*    characters. termWrite appends to it and returns at once;
+*    the characters are sent one by one by termInterrupt, the
+*    transmit-complete handler, or by termPoll where interrupts
+*    are not taken. termFlush waits until a ring is empty.
+*
+*/
+
+#include "../h/types.h"
+
+/* characters buffered per terminal, a power of 2 */
+#ifndef TERMBUFSIZE
+#define TERMBUFSIZE		1024
+#endif
+
+/* output state of one terminal */
+typedef struct termout_t {
+	char			to_buf[TERMBUFSIZE];	/* characters waiting to be sent */
+	unsigned int	to_head;				/* characters taken for transmission so far */
+	unsigned int	to_tail;				/* characters appended so far */
+	int				to_busy;				/* a character is being transmitted */
+	int				to_error;				/* the transmitter failed since initTermOut */
+} termout_t;
+
+extern void 	initTermOut 	(void);
+extern int 		termWrite 		(int term, char *str);
+extern void 	termInterrupt 	(int term);
+extern void 	termPoll 		(int term);
+extern int 		termFlush 		(int term);
+
+/***************************************************************/
+
+#endif
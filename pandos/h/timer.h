@@ -0,0 +1,34 @@
+#ifndef TIMER
+#define TIMER
+
+/************************** TIMER.H ****************************
+*
+*  The externals declaration file for the Timer Events Module.
+*
+*  The end of the running quantum, the head of the sleep queue
+*    and the next pseudo-clock tick (only while a process waits
+*    for it) share the interval timer: armTimers programs it for
+*    the nearest of them only, and dueTimers tells the interrupt
+*    handler which ones have come.
+*
+*/
+
+#include "../h/types.h"
+
+/* timer events, as returned by dueTimers */
+#define TM_QUANTUM		1		/* the running quantum is over */
+#define TM_SLEEP		2		/* the head of the sleep queue is due */
+#define TM_CLOCK		4		/* a pseudo-clock tick went by */
+#define TM_ARMED		8		/* (tm_active only) timer loaded for tm_armed */
+#define TM_PARKED		16		/* (tm_active only) timer loaded with no deadline */
+
+extern void 	initTimers 		(timers_PTR tm, sleepq_PTR sq, int *clockSem);
+extern void 	startQuantum 	(timers_PTR tm, cpu_t len);
+extern void 	stopQuantum 	(timers_PTR tm);
+extern cpu_t 	nextDeadline 	(timers_PTR tm);
+extern int 		dueTimers 		(timers_PTR tm);
+extern void 	armTimers 		(timers_PTR tm);
+
+/***************************************************************/
+
+#endif
@@ -0,0 +1,68 @@
+#ifndef TRACE
+#define TRACE
+
+/************************** TRACE.H ****************************
+*
+*  The externals declaration file for the phase 1 Event Trace
+*    Module.
+*
+*  Built with PHASE1_TRACE, the PCB and ASL modules record one
+*    fixed-size binary event (traceev_t) in a ring of TRACESIZE
+*    entries for every PCB allocation and free, process queue
+*    insertion and removal, block and unblock, and process tree
+*    change; the oldest events are overwritten. Nothing is printed
+*    until dumpTrace is called. Without PHASE1_TRACE the macro
+*    below expands to nothing.
+*
+*/
+
+#include "../h/types.h"
+
+/* traced events */
+#define TR_ALLOC			0	/* PCB allocated */
+#define TR_FREE				1	/* PCB freed */
+#define TR_ENQUEUE			2	/* PCB inserted in the queue of tail pointer te_addr */
+#define TR_DEQUEUE			3	/* PCB removed from the queue of tail pointer te_addr */
+#define TR_BLOCK			4	/* PCB blocked on semaphore te_addr */
+#define TR_UNBLOCK			5	/* PCB unblocked from semaphore te_addr */
+#define TR_UNBLOCKALL		6	/* whole queue of semaphore te_addr, of tail PCB, unblocked */
+#define TR_INSCHILD			7	/* PCB made a child of PCB te_addr */
+#define TR_OUTCHILD			8	/* PCB detached from its parent te_addr */
+#define TR_ADOPT			9	/* children of PCB moved to PCB te_addr */
+#define TRACEOPS			10
+
+/* ring size, a power of 2 */
+#ifndef TRACESIZE
+#define TRACESIZE			256
+#endif
+
+/* one traced event */
+typedef struct traceev_t {
+	cpu_t			te_time;		/* TOD of the event (STCK) */
+	void			*te_addr;		/* semaphore, queue or parent, by event */
+	unsigned short	te_pcb;			/* pool index of the PCB, NOLINK if none */
+	unsigned short	te_op;			/* TR_ constant */
+} traceev_t;
+
+#ifdef PHASE1_TRACE
+
+extern traceev_t	traceRing[TRACESIZE];
+extern unsigned int	traceCount;
+
+extern void 	traceEvent 		(int op, pcb_PTR p, void *addr);
+
+/* Records event OP of PCB P (or NULL) about address A */
+#define TRACE_EVENT(OP, P, A)	traceEvent((OP), (P), (void *) (A))
+
+#else
+
+#define TRACE_EVENT(OP, P, A)	((void) 0)
+
+#endif
+
+extern void 	resetTrace 		(void);
+extern void 	dumpTrace 		(void (*print)(char *));
+
+/***************************************************************/
+
+#endif
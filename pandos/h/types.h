@@ -14,6 +14,19 @@ typedef signed int cpu_t;
 
 typedef unsigned int memaddr;
 
+typedef unsigned int procid_t;		/* generation-checked process handle */
+
+typedef volatile unsigned int spinlock_t;	/* 0 when free (see h/spin.h) */
+
+/* links between PCBs and between semaphore descriptors (see h/link.h) */
+#ifdef LINK_INDEX
+typedef unsigned short pcblink_t;	/* index in the PCB pool, or NOLINK */
+typedef unsigned short semdlink_t;	/* index in the descriptor pool, or NOLINK */
+#else
+typedef struct pcb_t *pcblink_t;
+typedef struct semd_t *semdlink_t;
+#endif
+
 
 /* Device Register */
 typedef struct {
@@ -99,32 +112,123 @@ typedef struct state_t {
 #define s_HI	s_reg[29]
 #define s_LO	s_reg[30]
 
-/* process control block type */
+/* process control block type
+ *
+ * Only the fields used by queue, tree and scheduling operations are kept 
+ * here, densely packed; the saved processor state lives in a separate pool 
+ * (see initPcbs) and is reached through p_s, so walks over PCBs do not drag 
+ * register save areas through the cache. Building with PCB_INLINESTATE 
+ * keeps the state inside each PCB instead, for comparison. 
+ *
+ * The links come first and are read and written through h/link.h; built 
+ * with LINK_INDEX they are 16-bit pool indexes, so they take a quarter 
+ * of the space of host pointers and half that of uMPS3 ones. */
 typedef struct pcb_t {
 	/* process queue fields */
-	struct pcb_t	*p_next,		/* ptr to next entry*/
-					*p_prev,		/* ptr to prev entry*/
+	pcblink_t		p_next,			/* ptr to next entry*/
+					p_prev,			/* ptr to prev entry*/
 
 	/* process tree fields */
-					*p_parent,		/* ptr to parent */
-					*p_child,		/* ptr to 1st child */
-					*p_sib_next,	/* ptr to next sibling */
-					*p_sib_prev;	/* ptr to prev sibling */
+					p_parent,		/* ptr to parent */
+					p_child,		/* ptr to 1st child */
+					p_lastChild,	/* ptr to last child */
+					p_sib_next,		/* ptr to next sibling */
+					p_sib_prev,		/* ptr to prev sibling */
+
+	/* live list fields */
+					p_live_next,	/* ptr to next allocated PCB */
+					p_live_prev,	/* ptr to prev allocated PCB */
+
+	/* priority wait queue field (p_next, p_prev: sibling, prev sibling or parent) */
+					p_heapChild;	/* ptr to 1st child in the heap */
+	semdlink_t		p_semd;			/* ptr to descriptor of the sema4 */
+
+	/* process queue ownership */
+	struct pcb_t	**p_queue;		/* tail ptr of the queue holding proc */
 
 	/* process status info */
-	state_t			p_s;			/* processor state */
-	cpu_t			p_time;			/* cpu time used by proc */
 	int 			*p_semAdd;		/* ptr to sema4 on which process blocked */
+	cpu_t			p_time;			/* cpu time used by proc */
+	int				p_prio;			/* ready queue priority (0 is highest) */
+	int				p_nchild;		/* number of children */
+	unsigned int	p_gen;			/* generation, odd while allocated */
+	cpu_t			p_delta;		/* sleep queue: wakeup time after the previous entry's; 
+									 * priority wait queue: arrival number */
+#ifdef PHASE1_ACCT
+	cpu_t			p_qtime;		/* TOD when queued, then the length of that stay */
+	cpu_t			p_wait;			/* total time spent in queues */
+#endif
+	state_PTR		p_s;			/* ptr to processor state */
 	/*Not implemented in Phase 1
 	support layer information 
 	support_t		*p_semAdd;		 ptr to support struct */
+#ifdef PCB_INLINESTATE
+	state_t			p_state;		/* processor state, when kept inline */
+#endif
 } pcb_t, *pcb_PTR;
 
-/* sempahore descriptor type */
+/* per-PCB callback used by the process tree walks */
+typedef void (*pcbVisit_t)(pcb_PTR p, void *arg);
+
+/* log2 histogram of queue waits (see ACCTBUCKETS) */
+typedef struct waithist_t {
+	unsigned int	wh_count;				/* waits recorded */
+	cpu_t			wh_total;				/* their total length */
+	cpu_t			wh_max;					/* the longest */
+	unsigned int	wh_bucket[ACCTBUCKETS];	/* waits per length class */
+} waithist_t, *waithist_PTR;
+
+/* sempahore descriptor type (links through h/link.h, as in pcb_t) */
 typedef struct semd_t {
-	struct semd_t 	*s_next;		/* next element on the ASL */
 	int 			*s_semAdd;		/* ptr to the sema4 */
-	pcb_PTR			s_procQ;		/* tail ptr to a process queue */
+	pcb_PTR			s_procQ;		/* tail ptr to a process queue, or heap root */
+	int				s_byPrio;		/* TRUE when s_procQ is a priority heap */
+	unsigned int	s_seq;			/* arrivals on the heap, for FIFO among equals */
+	semdlink_t		*s_pprev;		/* ASL link pointing to this element */
+	semdlink_t		s_next;			/* next element on the ASL */
+#ifdef ASL_HYSTERESIS
+	semdlink_t		s_lruNext,		/* next (older) inactive descriptor */
+					s_lruPrev;		/* previous (newer) inactive descriptor */
+#endif
+#ifdef PHASE1_ACCT
+	waithist_PTR	s_hist;			/* waits of the processes blocked here, by address */
+#endif
 } semd_t, *semd_PTR;
 
+/* counters of the inactive descriptor cache of the ASL (ASL_HYSTERESIS) */
+typedef struct semdcache_t {
+	unsigned int	sc_parks;		/* descriptors kept when their queue emptied */
+	unsigned int	sc_hits;		/* kept descriptors reused: reallocations saved */
+	unsigned int	sc_reclaims;	/* kept descriptors freed for another semaphore */
+	int				sc_inactive;	/* descriptors kept right now */
+} semdcache_t;
+
+/* multi-level ready queue type */
+typedef struct readyq_t {
+	unsigned int	rq_bitmap;				/* bit i set iff level i is non-empty */
+	pcb_PTR			rq_tail[PRIOLEVELS];	/* tail ptr of each level's queue */
+#ifdef PHASE1_SMP
+	spinlock_t		rq_lock;				/* guards the whole ready queue */
+#endif
+#ifdef PHASE1_ACCT
+	waithist_t		rq_hist[PRIOLEVELS];	/* waits of the processes of each level */
+#endif
+} readyq_t, *readyq_PTR;
+
+/* sleep queue (delta list) type */
+typedef struct sleepq_t {
+	pcb_PTR			sq_tail;		/* tail ptr of the queue, by wakeup time */
+	cpu_t			sq_stamp;		/* TOD the head's p_delta is counted from */
+} sleepq_t, *sleepq_PTR;
+
+/* timer events: the deadlines sharing the interval timer (see h/timer.h) */
+typedef struct timers_t {
+	sleepq_PTR		tm_sleepq;		/* sleep queue whose head is a deadline, or NULL */
+	int				*tm_clockSem;	/* pseudo-clock semaphore, or NULL */
+	cpu_t			tm_quantum;		/* TOD the running quantum ends */
+	cpu_t			tm_tick;		/* TOD of the next pseudo-clock tick */
+	cpu_t			tm_armed;		/* TOD the interval timer is armed for */
+	unsigned int	tm_active;		/* TM_QUANTUM, TM_ARMED and TM_PARKED bits */
+} timers_t, *timers_PTR;
+
 #endif
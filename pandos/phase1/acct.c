@@ -0,0 +1,149 @@
+/******************************* acct.c **************************************
+ *
+ *  Module: Phase 1 Accounting
+ *
+ *  This module keeps the per-process time accounting of phase 1 (see 
+ *  `h/acct.h`):
+ *  
+ *  - CPU time: `chargeCpu` adds the TOD time elapsed since a given 
+ *    instant (e.g. the last dispatch) to the PCB's `p_time`.
+ *  - Queue waits (`PHASE1_ACCT`): `insertProcQ` stamps a PCB with the 
+ *    TOD (`p_qtime`) and `outProcQ` turns the stamp into the length 
+ *    of the stay, added to `p_wait`. The ASL and the ready queue then 
+ *    record that length in the histogram of the semaphore 
+ *    or ready queue level the PCB left.
+ *
+ *  Data Structures Used:
+ *  
+ *  - Histogram: `waithist_t` counts waits by length class, class b 
+ *    holding waits of 2^(b-1) up to 2^b - 1 units. The class is the 
+ *    position of the wait's highest set bit, so recording costs a 
+ *    constant number of instructions whatever the wait.
+ *
+ *****************************************************************************/
+
+#include "../h/acct.h"
+#include "../h/bitmap.h"
+#include "../h/fmt.h"
+#include "../h/port.h"
+
+/***************************************************************
+ *  chargeCpu - Charges Elapsed CPU Time to a Process
+ *
+ *  Parameters:
+ *    - p:     PCB of the process that was running.
+ *    - since: TOD at which it started running.
+ ***************************************************************/
+void chargeCpu(pcb_PTR p, cpu_t since) {
+	cpu_t now;
+
+	if (NULL == p) return;
+
+	STCK(now);
+	p->p_time += now - since;
+}
+
+#ifdef PHASE1_ACCT
+
+/***************************************************************
+ *  acctEnqueue - Stamps a PCB Entering a Queue
+ *
+ *  Parameters:
+ *    - p: PCB being queued.
+ ***************************************************************/
+void acctEnqueue(pcb_PTR p) {
+	STCK(p->p_qtime);
+}
+
+/***************************************************************
+ *  acctDequeue - Closes the Stay of a PCB Leaving a Queue
+ *
+ *  Replaces the enqueue stamp by the length of the stay and adds 
+ *  it to the PCB's total wait.
+ *
+ *  Parameters:
+ *    - p: PCB being removed.
+ ***************************************************************/
+void acctDequeue(pcb_PTR p) {
+	cpu_t now;
+
+	STCK(now);
+	p->p_qtime = now - p->p_qtime;
+	p->p_wait += p->p_qtime;
+}
+
+#endif
+
+/***************************************************************
+ *  resetHist - Clears a Wait Histogram
+ *
+ *  Parameters:
+ *    - h: Pointer to the histogram.
+ ***************************************************************/
+void resetHist(waithist_PTR h) {
+	int i;
+
+	h->wh_count = 0;
+	h->wh_total = h->wh_max = 0;
+	for (i = 0; i < ACCTBUCKETS; ++i)
+		h->wh_bucket[i] = 0;
+}
+
+/***************************************************************
+ *  recordHist - Records One Wait in a Histogram
+ *
+ *  Parameters:
+ *    - h:    Pointer to the histogram.
+ *    - wait: Length of the wait (TOD units).
+ ***************************************************************/
+void recordHist(waithist_PTR h, cpu_t wait) {
+	int b;
+
+	wait = MAX(wait, 0);
+
+	/* Class of the wait: position of its highest bit, plus one */
+	b = (0 == wait) ? 0 : MIN(lastSetBit((unsigned int) wait) + 1, ACCTBUCKETS - 1);
+
+	h->wh_count++;
+	h->wh_total += wait;
+	h->wh_max = MAX(h->wh_max, wait);
+	h->wh_bucket[b]++;
+}
+
+/***************************************************************
+ *  dumpHist - Prints a Wait Histogram
+ *
+ *  This function formats the histogram as one line, in the form
+ *
+ *      hist,name,count,total,max,b0,b1,...
+ *
+ *  with one field per length class, and passes it to `print`.
+ *
+ *  Parameters:
+ *    - name:  Label of the histogram (e.g. the semaphore's).
+ *    - h:     Pointer to the histogram.
+ *    - print: Function receiving the EOS-terminated line.
+ ***************************************************************/
+void dumpHist(char *name, waithist_PTR h, void (*print)(char *)) {
+	char line[64 + 12 * ACCTBUCKETS];
+	char *lp;
+	int i;
+
+	lp = fmtstr(line, "hist,");
+	while (*name != EOS && lp < line + 32)
+		*lp++ = *name++;
+	*lp++ = ',';
+	lp = fmtuint(lp, h->wh_count);
+	*lp++ = ',';
+	lp = fmtuint(lp, (unsigned int) h->wh_total);
+	*lp++ = ',';
+	lp = fmtuint(lp, (unsigned int) h->wh_max);
+	for (i = 0; i < ACCTBUCKETS; ++i) {
+		*lp++ = ',';
+		lp = fmtuint(lp, h->wh_bucket[i]);
+	}
+	*lp++ = '\n';
+	*lp = EOS;
+
+	print(line);
+}
@@ -25,6 +25,36 @@
  *    in ascending order, using `s_semAdd` as the sorting key.
  *  - Queue: Each semaphore has a process queue, implemented as a circular 
  *    doubly linked list.
+ *  - Pairing Heap (optional): A queue whose first waiter was blocked with 
+ *    `insertBlockedPrio` is instead a heap ordered by priority (`p_prio`), 
+ *    then arrival, rooted at `s_procQ` and linked through `p_heapChild`, 
+ *    `p_next` and `p_prev` (`s_byPrio`). Insertion stays O(1); removing 
+ *    the first or any other waiter costs O(log n) amortized. A waiter 
+ *    changes priority only through `setBlockedPrio`, which moves it.
+ *  - Hash Table (optional): When built with `ASL_HASH`, the ASL is instead 
+ *    an array of `ASLHASHSIZE` buckets, each a NULL-terminated singly linked 
+ *    chain of descriptors whose `s_semAdd` hashes to that bucket. Lookups 
+ *    then cost O(1) on average instead of O(active semaphores).
+ *
+ *  Both backends are reached through `traverseASL`, which returns the link 
+ *  (the `s_next` field or bucket head) that points at the descriptor for a 
+ *  semaphore, or at the place where it would be inserted. Insertion and 
+ *  removal are then the same pointer update for either backend.
+ *
+ *  Device semaphores (optional): an array of `DEVSEMNUM` semaphores 
+ *  registered with `registerDevSems` bypasses the ASL altogether. Each 
+ *  of its semaphores owns a preallocated descriptor of `devSemdTable`, 
+ *  found by index in O(1) and never freed, so the P/V traffic of the 
+ *  interrupt handlers costs no lookup and no descriptor churn.
+ *
+ *  Every active descriptor also remembers the link that points at it 
+ *  (`s_pprev`), and every blocked PCB remembers its descriptor (`p_semd`), 
+ *  so a known descriptor or PCB is unlinked in O(1) without any search.
+ *
+ *  All descriptors live in one static array (`semdPool`) and their links 
+ *  go through `h/link.h`, so with `LINK_INDEX` the ASL, free list and LRU 
+ *  links are 16-bit indexes into it, like the PCB links. `s_pprev` stays 
+ *  a pointer, since it may point at a bucket head.
  *
  *  This module ensures:
  *  
@@ -32,100 +62,781 @@
  *  - Safe insertion (`insertBlocked`) and removal (`removeBlocked`, `outBlocked`) 
  *    of PCBs into/from semaphore queues.
  *  - Efficient retrieval of the first blocked process (`headBlocked`).
+ *  - An unchecked tier (`outBlockedUnchecked`) for callers that know the 
+ *    PCB is blocked, like the PCB module's (see `h/check.h`); the module 
+ *    itself moves PCBs through the unchecked procQ functions, so each 
+ *    operation validates its arguments once.
+ *  - Optionally (`PHASE1_STATS`), per-operation call, iteration and time 
+ *    counters (see `h/stats.h`).
+ *  - Optionally (`PHASE1_ACCT`), a wait histogram per semaphore (see 
+ *    `semWaitHist`). The histograms live outside the descriptor pool, 
+ *    keyed by semaphore address (`semHistTable`), so they survive the 
+ *    reuse of descriptors; a descriptor only points at its semaphore's 
+ *    (`s_hist`). Semaphores that find no slot share `semHistOther`.
+ *  - Optionally (`PHASE1_TRACE`), block and unblock events in the trace 
+ *    ring (see `h/trace.h`); `removeAllBlocked` records one event for 
+ *    the whole queue.
+ *  - Optionally (`ASL_HYSTERESIS`), descriptors whose queue empties stay 
+ *    on the ASL as inactive entries, on an LRU list (`semdLru_h`), and a 
+ *    later P on the same semaphore reuses them without unlinking and 
+ *    re-inserting anything. They are reclaimed, oldest first, only 
+ *    when the free list runs out; `semdCache` counts how often this 
+ *    saves a reallocation. Inactive entries have empty queues, so they 
+ *    are invisible to `headBlocked` and `removeBlocked`, but sorted 
+ *    list lookups still step over them.
+ *  - Optionally (`PHASE1_SMP`), fine-grained locking for multiprocessor 
+ *    kernels: one spinlock per hash bucket, one per device descriptor 
+ *    and one for the free list (see `h/spin.h`). Each operation holds 
+ *    only the lock of the semaphore it names (`semLock`), so P and V on 
+ *    unrelated semaphores proceed in parallel; `outBlocked` re-checks 
+ *    under the lock that the PCB is still blocked where it was seen.
  *
  *****************************************************************************/
 #include "../h/asl.h"
 #include "../h/pcb.h"
+#include "../h/stats.h"
+#include "../h/acct.h"
+#include "../h/check.h"
+#include "../h/spin.h"
+#include "../h/trace.h"
 
-HIDDEN semd_PTR semd_h;			/* Head of the Active Semaphore List (ASL) */
 HIDDEN semd_PTR semdFree_h;		/* Head of the Free Semaphore Descriptor List */
+#ifdef ASL_HASH
+HIDDEN semdlink_t semdHash_h[ASLHASHSIZE];	/* Bucket heads of the hashed ASL */
+
+/* Fibonacci hash of a semaphore address onto an ASL bucket */
+#define ASLHASH(A)	((((unsigned int) (unsigned long) (A) >> 2) * 2654435761U) >> (32 - ASLHASHBITS))
+#else
+HIDDEN semd_PTR semd_h;			/* Head of the Active Semaphore List (ASL) */
+#endif
+
+/* Statically allocated descriptors: MAXSEMD for the ASL, its dummy 
+ * nodes, then one per device semaphore (`devSemdTable`) */
+#ifdef LINK_INDEX
+semd_t semdPool[SEMDPOOLSIZE];			/* Indexed by links */
+#else
+HIDDEN semd_t semdPool[SEMDPOOLSIZE];
+#endif
+#define devSemdTable	(semdPool + MAXSEMD + DUMMYVARCOUNT)
+
+HIDDEN int *devSem_h;			/* Registered device semaphores, or NULL */
+
+/* TRUE if the descriptor S belongs to a device semaphore */
+#define ISDEVSEMD(S)	((S) >= devSemdTable && (S) < devSemdTable + DEVSEMNUM)
+
+#ifdef ASL_HYSTERESIS
+HIDDEN semd_PTR semdLru_h, semdLru_t;	/* Inactive descriptors, newest first */
+semdcache_t semdCache;					/* Counters of the inactive descriptors */
+
+/***************************************************************
+ *  parkSemd - Keeps an Emptied Descriptor as Inactive
+ *
+ *  The descriptor stays on the ASL and becomes the newest entry 
+ *  of the LRU list.
+ *
+ *  Parameters:
+ *    - semd: Pointer to the descriptor, whose queue is empty.
+ ***************************************************************/
+static void parkSemd(semd_PTR semd) {
+	semd->s_lruPrev = NILLINK;
+	SETSEMD(semd, s_lruNext, semdLru_h);
+	if (NULL != semdLru_h)
+		SETSEMD(semdLru_h, s_lruPrev, semd);
+	else
+		semdLru_t = semd;
+	semdLru_h = semd;
+
+	semdCache.sc_parks++;
+	semdCache.sc_inactive++;
+}
+
+/***************************************************************
+ *  unparkSemd - Takes a Descriptor off the LRU List
+ *
+ *  Parameters:
+ *    - semd: Pointer to an inactive descriptor.
+ ***************************************************************/
+static void unparkSemd(semd_PTR semd) {
+	if (NILLINK != semd->s_lruPrev)
+		GETSEMD(semd, s_lruPrev)->s_lruNext = semd->s_lruNext;
+	else
+		semdLru_h = GETSEMD(semd, s_lruNext);
+	if (NILLINK != semd->s_lruNext)
+		GETSEMD(semd, s_lruNext)->s_lruPrev = semd->s_lruPrev;
+	else
+		semdLru_t = GETSEMD(semd, s_lruPrev);
+	semd->s_lruNext = semd->s_lruPrev = NILLINK;
+
+	semdCache.sc_inactive--;
+}
+#endif
+
+/***************************************************************
+ *  devSemd - Maps a Device Semaphore to its Descriptor
+ *
+ *  Parameters:
+ *    - semAdd: Pointer to the semaphore address.
+ *
+ *  Returns:
+ *    - The preallocated descriptor if `semAdd` lies in the 
+ *      registered device semaphore array.
+ *    - NULL otherwise (the semaphore lives in the ASL).
+ ***************************************************************/
+static semd_PTR devSemd(int *semAdd) {
+	if (NULL == devSem_h || semAdd < devSem_h || semAdd >= devSem_h + DEVSEMNUM)
+		return NULL;
+	return &devSemdTable[semAdd - devSem_h];
+}
+
+#ifdef PHASE1_ACCT
+HIDDEN int *semHistKey[SEMHISTSIZE];			/* Semaphore of each slot, or NULL */
+HIDDEN waithist_t semHistTable[SEMHISTSIZE];	/* Wait histograms, by semaphore address */
+HIDDEN waithist_t semHistOther;					/* Waits of the semaphores without a slot */
+HIDDEN waithist_t devSemHist[DEVSEMNUM];		/* Waits of the device semaphores */
+#ifdef PHASE1_SMP
+HIDDEN spinlock_t semHistLock;					/* Guards the slot keys and semHistOther */
+#endif
+
+/* Fibonacci hash of a semaphore address onto its first histogram slot */
+#define SEMHISTHASH(A)	((((unsigned int) (unsigned long) (A) >> 2) * 2654435761U) >> (32 - SEMHISTBITS))
+
+/***************************************************************
+ *  semHist - Finds the Wait Histogram of a Semaphore
+ *
+ *  At most `SEMHISTPROBES` slots are probed from the one `semAdd` 
+ *  hashes to, so the cost is bounded even once the table is full. 
+ *  Slots are never given back: a semaphore keeps its histogram 
+ *  until `initASL`.
+ *
+ *  Parameters:
+ *    - semAdd: Pointer to the semaphore address (not a device one).
+ *    - claim:  TRUE to take a free slot if `semAdd` has none.
+ *
+ *  Returns:
+ *    - Pointer to the semaphore's histogram.
+ *    - `semHistOther` if no slot was found and `claim` is TRUE, 
+ *      NULL if it is FALSE.
+ ***************************************************************/
+static waithist_PTR semHist(int *semAdd, int claim) {
+	unsigned int i, n;
+	waithist_PTR h = claim ? &semHistOther : NULL;
+
+	LOCK(&semHistLock);
+	for (i = SEMHISTHASH(semAdd), n = 0; n < SEMHISTPROBES; i = (i + 1) & (SEMHISTSIZE - 1), n++) {
+		if (semHistKey[i] == semAdd) {
+			h = &semHistTable[i];
+			break;
+		}
+		if (NULL == semHistKey[i]) {
+			if (claim) {
+				semHistKey[i] = semAdd;
+				h = &semHistTable[i];
+			}
+			break;
+		}
+	}
+	UNLOCK(&semHistLock);
+
+	return h;
+}
+
+/***************************************************************
+ *  recordSemWait - Records the Wait of a PCB Leaving a Semaphore
+ *
+ *  The caller holds the semaphore's lock, which covers its own 
+ *  histogram; `semHistOther` is shared, and guarded separately.
+ *
+ *  Parameters:
+ *    - semd: Descriptor the PCB was blocked on.
+ *    - p:    PCB whose stay was just closed.
+ ***************************************************************/
+static void recordSemWait(semd_PTR semd, pcb_PTR p) {
+	if (&semHistOther != semd->s_hist) {
+		ACCT_RECORD(semd->s_hist, p);
+		return;
+	}
+
+	LOCK(&semHistLock);
+	ACCT_RECORD(&semHistOther, p);
+	UNLOCK(&semHistLock);
+}
+#endif
+
+#ifdef PHASE1_SMP
+HIDDEN spinlock_t semdHashLock[ASLHASHSIZE];	/* One per bucket of the hashed ASL */
+HIDDEN spinlock_t devSemLock[DEVSEMNUM];		/* One per device semaphore */
+HIDDEN spinlock_t semdFreeLock;					/* Guards the free list */
+
+/***************************************************************
+ *  semLock - Maps a Semaphore to the Lock Guarding it
+ *
+ *  Parameters:
+ *    - semAdd: Pointer to the semaphore address.
+ *
+ *  Returns:
+ *    - The lock of its device descriptor, for a registered device 
+ *      semaphore, or else of the ASL bucket it hashes to.
+ ***************************************************************/
+static spinlock_t *semLock(int *semAdd) {
+	if (NULL != devSem_h && semAdd >= devSem_h && semAdd < devSem_h + DEVSEMNUM)
+		return &devSemLock[semAdd - devSem_h];
+	return &semdHashLock[ASLHASH(semAdd)];
+}
+#endif
 
 /***************************************************************
  *  traverseASL - Traverses the Active Semaphore List (ASL)
  *
- *  This function searches the sorted singly linked ASL to find 
- *  the node preceding the given semaphore (`semAdd`).
+ *  This function searches the ASL for the given semaphore 
+ *  (`semAdd`) and returns the link that points at it.
  *
- *  - The ASL is sorted in ascending order using `s_semAdd`.
- *  - If `semAdd` is greater than the next node's `s_semAdd`, 
- *    traversal continues.
- *  - If `semAdd` is less than or equal to `s_semAdd` of the next node, 
- *    traversal stops, and the function returns the node before it.
+ *  - Sorted list backend: the ASL is sorted in ascending order 
+ *    using `s_semAdd`; traversal stops at the first node whose 
+ *    `s_semAdd` is greater than or equal to `semAdd` (at the 
+ *    latest, the tail dummy node).
+ *  - Hash backend (`ASL_HASH`): only the chain of the bucket 
+ *    `semAdd` hashes to is searched; traversal stops at the 
+ *    matching node or at the end of the chain.
  *
  *  Parameters:
  *    - semAdd: Pointer to the semaphore address.
  *
  *  Returns:
- *    - Pointer to the node preceding the target semaphore.
+ *    - Pointer to the link (previous node's `s_next`, or bucket 
+ *      head) that points at the target, or where it belongs.
  *    - NULL if `semAdd` is NULL.
  ***************************************************************/
-static semd_PTR traverseASL(int *semAdd) {
-	semd_PTR iter;
+static semdlink_t *traverseASL(int *semAdd) {
+	semdlink_t *link;
+	STAT_ENTER(ST_TRAVERSEASL)
 
 	/* Return NULL if semAdd is invalid */
 	if (NULL == semAdd) return NULL;
 
+#ifdef ASL_HASH
+	/* Walk the bucket's chain until the match or its end */
+	for (link = &semdHash_h[ASLHASH(semAdd)];
+		 NILLINK != *link && SEMDREF(*link)->s_semAdd != semAdd;
+		 link = &(SEMDREF(*link)->s_next))
+		STAT_ITER(ST_TRAVERSEASL);
+#else
 	/* Traverse the ASL to find the correct position */
-	for (iter = semd_h;
-		 semAdd > iter->s_next->s_semAdd && iter->s_semAdd < (int*) MAX_INT; 
-		 iter = iter->s_next);	
+	for (link = &(semd_h->s_next);
+		 semAdd > SEMDREF(*link)->s_semAdd && NILLINK != SEMDREF(*link)->s_next;
+		 link = &(SEMDREF(*link)->s_next))
+		STAT_ITER(ST_TRAVERSEASL);
+#endif
 
-	return iter;	/* Return the node before the target */
+	return link;	/* Return the link to the target */
 }
 
+/***************************************************************
+ *  activeSemd - Checks a Link Returned by traverseASL
+ *
+ *  Parameters:
+ *    - link:   Link returned by `traverseASL(semAdd)`.
+ *    - semAdd: Pointer to the semaphore address.
+ *
+ *  Returns:
+ *    - The descriptor of `semAdd` if it is on the ASL.
+ *    - NULL otherwise.
+ ***************************************************************/
+static semd_PTR activeSemd(semdlink_t *link, int *semAdd) {
+	if (NULL == link || NILLINK == *link || SEMDREF(*link)->s_semAdd != semAdd) return NULL;
+
+	return SEMDREF(*link);
+}
 
 /***************************************************************
- *  insertBlocked - Inserts a Process into a Semaphore's Queue
+ *  findSemd - Looks up the Descriptor of a Semaphore
  *
- *  This function blocks a process (`p`) on the given semaphore (`semAdd`). 
- *  If the semaphore is already active, `p` is inserted into its queue.
- *  Otherwise, a new semaphore descriptor is allocated from `semdFree_h`.
+ *  One lookup: the device semaphore table, else one traversal 
+ *  of the ASL.
  *
  *  Parameters:
  *    - semAdd: Pointer to the semaphore address.
- *    - p: Pointer to the PCB to be blocked.
  *
  *  Returns:
- *    - FALSE (0) if successful.
- *    - TRUE (1) if `p` is NULL, `semAdd` is NULL, or if no free semaphore 
- *      descriptors are available.
+ *    - The descriptor of `semAdd` (possibly inactive, with 
+ *      `ASL_HYSTERESIS`).
+ *    - NULL if `semAdd` has none.
  ***************************************************************/
-int insertBlocked(int *semAdd, pcb_PTR p) {
-	semd_PTR semdIns, semdLoc;
+static semd_PTR findSemd(int *semAdd) {
+	semd_PTR semdLoc;
 
-	/* Case 1: Invalid input */
-	if (NULL == p || NULL == semAdd) return TRUE;
+	semdLoc = devSemd(semAdd);
+	if (NULL == semdLoc)
+		semdLoc = activeSemd(traverseASL(semAdd), semAdd);
+
+	return semdLoc;
+}
 
-	/* Associate process with the given semaphore */
-	p->p_semAdd = semAdd;
 
-	/* Locate the correct position in the ASL */
-	semdLoc = traverseASL(semAdd);
+/***************************************************************
+ *  freeSemd - Returns an Active Descriptor to the Free List
+ *
+ *  This function unlinks `semd` from the ASL through its 
+ *  `s_pprev` link (no traversal needed) and pushes it onto 
+ *  `semdFree_h`.
+ *
+ *  Parameters:
+ *    - semd: Pointer to the descriptor, whose queue is empty.
+ ***************************************************************/
+static void freeSemd(semd_PTR semd) {
+	/* Remove semaphore from ASL */
+	*(semd->s_pprev) = semd->s_next;
+	if (NILLINK != semd->s_next)
+		GETSEMD(semd, s_next)->s_pprev = semd->s_pprev;
 
-	/* Case 2: Semaphore is already active, add to its queue */
-	if (semdLoc->s_next->s_semAdd == semAdd) {
-        insertProcQ(&(semdLoc->s_next->s_procQ), p);
+	/* Return it to the free list */
+	semd->s_procQ = mkEmptyProcQ();
+	semd->s_semAdd = NULL;
+	semd->s_pprev = NULL;
+	LOCK(&semdFreeLock);
+	SETSEMD(semd, s_next, semdFree_h);
+	semdFree_h = semd;
+	UNLOCK(&semdFreeLock);
+}
+
+/***************************************************************
+ *  allocSemd - Activates a Free Semaphore Descriptor
+ *
+ *  This function pops a descriptor off `semdFree_h`, initializes 
+ *  it for `semAdd` and links it into the ASL at `link`. With 
+ *  `ASL_HYSTERESIS`, an empty free list is first refilled with 
+ *  the oldest inactive descriptor.
+ *
+ *  Parameters:
+ *    - link:   Link returned by `traverseASL(semAdd)`.
+ *    - semAdd: Pointer to the semaphore address.
+ *
+ *  Returns:
+ *    - Pointer to the new descriptor.
+ *    - NULL if no free semaphore descriptors are available.
+ ***************************************************************/
+static semd_PTR allocSemd(semdlink_t *link, int *semAdd) {
+	semd_PTR semdIns;
 
-        return FALSE;
-    }
+#ifdef ASL_HYSTERESIS
+	/* Free list exhausted: reclaim the oldest inactive descriptor */
+	if (NULL == semdFree_h && NULL != semdLru_t) {
+		semdIns = semdLru_t;
+		unparkSemd(semdIns);
+		freeSemd(semdIns);
+		semdCache.sc_reclaims++;
 
-	/* Case 3: No free semaphore descriptors available */
-    if (NULL == semdFree_h) return TRUE;
+		/* link may have been the reclaimed descriptor's s_next */
+		link = traverseASL(semAdd);
+	}
+#endif
 
-	/* Case 4: Allocate new semaphore descriptor */
+	/* Pop a descriptor off the free list */
+	LOCK(&semdFreeLock);
 	semdIns = semdFree_h;
-	semdFree_h = semdFree_h->s_next;	
-	
+	if (NULL != semdIns)
+		semdFree_h = GETSEMD(semdIns, s_next);
+	UNLOCK(&semdFreeLock);
+
+	/* No free semaphore descriptors available */
+	if (NULL == semdIns) return NULL;
+
 	/* Insert new semaphore descriptor into ASL */
-	semdIns->s_next = semdLoc->s_next;
-	semdLoc->s_next = semdIns;
+	semdIns->s_next = *link;
+	semdIns->s_pprev = link;
+	if (NILLINK != semdIns->s_next)
+		GETSEMD(semdIns, s_next)->s_pprev = &(semdIns->s_next);
+	*link = SEMDLINK(semdIns);
 
 	/* Initialize semaphore descriptor */
 	semdIns->s_procQ = mkEmptyProcQ();
 	semdIns->s_semAdd = semAdd;
-	insertProcQ(&(semdIns->s_procQ), p);
+#ifdef PHASE1_ACCT
+	semdIns->s_hist = semHist(semAdd, TRUE);
+#endif
+
+	return semdIns;
+}
+
+/***************************************************************
+ *  releaseSemd - Releases a Descriptor whose Queue Emptied
+ *
+ *  A device semaphore keeps its descriptor; with `ASL_HYSTERESIS` 
+ *  the descriptor stays on the ASL as an inactive entry; otherwise 
+ *  it is freed (`freeSemd`).
+ *
+ *  Parameters:
+ *    - semd: Pointer to the descriptor.
+ ***************************************************************/
+static void releaseSemd(semd_PTR semd) {
+	semd->s_procQ = mkEmptyProcQ();
+	if (ISDEVSEMD(semd)) return;
+
+#ifdef ASL_HYSTERESIS
+	parkSemd(semd);
+#else
+	freeSemd(semd);
+#endif
+}
+
+/***************************************************************
+ *  heapBefore - Orders the Waiters of a Priority Wait Queue
+ *
+ *  Returns:
+ *    - TRUE if `a` is to be unblocked before `b`: it has a higher 
+ *      priority (lower `p_prio`), or the same and arrived first.
+ ***************************************************************/
+static int heapBefore(pcb_PTR a, pcb_PTR b) {
+	if (a->p_prio != b->p_prio)
+		return (a->p_prio < b->p_prio);
+
+	return ((int) ((unsigned int) a->p_delta - (unsigned int) b->p_delta) < 0);
+}
+
+/***************************************************************
+ *  heapMeld - Melds Two Pairing Heaps
+ *
+ *  The root that comes second becomes the first child of the 
+ *  other.
+ *
+ *  Parameters:
+ *    - a, b: Roots of the two heaps (non-NULL).
+ *
+ *  Returns:
+ *    - Root of the melded heap, with no siblings.
+ ***************************************************************/
+static pcb_PTR heapMeld(pcb_PTR a, pcb_PTR b) {
+	pcb_PTR t;
+
+	if (heapBefore(b, a)) {
+		t = a;
+		a = b;
+		b = t;
+	}
+
+	b->p_next = a->p_heapChild;
+	if (NILLINK != b->p_next)
+		SETPCB(GETPCB(b, p_next), p_prev, b);
+	SETPCB(b, p_prev, a);
+	SETPCB(a, p_heapChild, b);
+	a->p_next = a->p_prev = NILLINK;
+
+	return a;
+}
+
+/***************************************************************
+ *  heapMerge - Melds a List of Sibling Heaps into One
+ *
+ *  The two-pass pairing of the pairing heap: the siblings are 
+ *  melded in pairs left to right, then the pairs are melded 
+ *  into one right to left, which keeps removals O(log n) 
+ *  amortized. The pairs are stacked through `p_next`.
+ *
+ *  Parameters:
+ *    - first: First of the siblings, or NULL.
+ *
+ *  Returns:
+ *    - Root of the merged heap, NULL if there were no siblings.
+ ***************************************************************/
+static pcb_PTR heapMerge(pcb_PTR first) {
+	pcb_PTR a, b, next, pairs = NULL;
+
+	if (NULL == first) return NULL;
+
+	/* Pass 1: meld the siblings two by two */
+	while (NULL != first) {
+		a = first;
+		b = GETPCB(a, p_next);
+		next = (NULL == b) ? NULL : GETPCB(b, p_next);
+		if (NULL != b)
+			a = heapMeld(a, b);
+		SETPCB(a, p_next, pairs);
+		pairs = a;
+		first = next;
+	}
+
+	/* Pass 2: meld the pairs, last to first */
+	a = pairs;
+	pairs = GETPCB(a, p_next);
+	a->p_next = a->p_prev = NILLINK;
+	while (NULL != pairs) {
+		next = GETPCB(pairs, p_next);
+		a = heapMeld(pairs, a);
+		pairs = next;
+	}
+
+	return a;
+}
+
+/***************************************************************
+ *  heapLink - Links a Waiter into a Priority Wait Queue
+ *
+ *  O(1): the new PCB is melded with the root. Only the heap links 
+ *  and the arrival number change; see `heapIn`.
+ *
+ *  Parameters:
+ *    - semd: Descriptor whose `s_procQ` is a heap.
+ *    - p:    PCB to be linked (in no heap).
+ ***************************************************************/
+static void heapLink(semd_PTR semd, pcb_PTR p) {
+	p->p_heapChild = p->p_next = p->p_prev = NILLINK;
+	p->p_delta = (cpu_t) semd->s_seq++;		/* Arrival number */
+
+	semd->s_procQ = emptyProcQ(semd->s_procQ) ? p : heapMeld(semd->s_procQ, p);
+}
+
+/***************************************************************
+ *  heapUnlink - Unlinks a Waiter from a Priority Wait Queue
+ *
+ *  The root costs O(log n) amortized; any other PCB is cut 
+ *  out of its sibling list, its children are merged, and the 
+ *  result is melded back with the root. Only the heap links 
+ *  change; see `heapOut`.
+ *
+ *  Parameters:
+ *    - semd: Descriptor whose `s_procQ` is a heap.
+ *    - p:    PCB in that heap.
+ ***************************************************************/
+static void heapUnlink(semd_PTR semd, pcb_PTR p) {
+	pcb_PTR prev, sub;
+
+	sub = heapMerge(GETPCB(p, p_heapChild));
+
+	if (p == semd->s_procQ)
+		semd->s_procQ = sub;
+	else {
+		/* p_prev is p's previous sibling, or its parent if p comes first */
+		prev = GETPCB(p, p_prev);
+		if (GETPCB(prev, p_heapChild) == p)
+			prev->p_heapChild = p->p_next;
+		else
+			prev->p_next = p->p_next;
+		if (NILLINK != p->p_next)
+			GETPCB(p, p_next)->p_prev = p->p_prev;
+
+		if (NULL != sub)
+			semd->s_procQ = heapMeld(semd->s_procQ, sub);
+	}
+
+	p->p_heapChild = p->p_next = p->p_prev = NILLINK;
+}
+
+/***************************************************************
+ *  heapIn - Inserts a Waiter into a Priority Wait Queue
+ *
+ *  Parameters:
+ *    - semd: Descriptor whose `s_procQ` is a heap.
+ *    - p:    PCB to be inserted (in no queue).
+ ***************************************************************/
+static void heapIn(semd_PTR semd, pcb_PTR p) {
+	heapLink(semd, p);
+	p->p_queue = &(semd->s_procQ);
+	ACCT_ENQUEUE(p);
+	TRACE_EVENT(TR_ENQUEUE, p, &(semd->s_procQ));
+}
+
+/***************************************************************
+ *  heapOut - Removes a Waiter from a Priority Wait Queue
+ *
+ *  Parameters:
+ *    - semd: Descriptor whose `s_procQ` is a heap.
+ *    - p:    PCB in that heap.
+ ***************************************************************/
+static void heapOut(semd_PTR semd, pcb_PTR p) {
+	heapUnlink(semd, p);
+	p->p_queue = NULL;
+	ACCT_DEQUEUE(p);
+	TRACE_EVENT(TR_DEQUEUE, p, &(semd->s_procQ));
+}
+
+/***************************************************************
+ *  heapToProcQ - Drains a Priority Wait Queue into a Process Queue
+ *
+ *  The waiters are linked, in the order they would have been 
+ *  unblocked, into a detached process queue as `removeAllBlocked` 
+ *  returns it: they keep their semaphore fields and ownership tag. 
+ *  Costs O(n log n).
+ *
+ *  Parameters:
+ *    - semd: Descriptor whose `s_procQ` is a heap, left empty.
+ *
+ *  Returns:
+ *    - Tail pointer of the process queue.
+ ***************************************************************/
+static pcb_PTR heapToProcQ(semd_PTR semd) {
+	pcb_PTR p, tp = mkEmptyProcQ();
+
+	while (!emptyProcQ(semd->s_procQ)) {
+		p = semd->s_procQ;
+		semd->s_procQ = heapMerge(GETPCB(p, p_heapChild));
+		p->p_heapChild = NILLINK;
+
+		/* Append p at the tail of tp */
+		if (emptyProcQ(tp))
+			p->p_next = p->p_prev = PCBLINK(p);
+		else {
+			p->p_next = tp->p_next;
+			SETPCB(p, p_prev, tp);
+			SETPCB(GETPCB(tp, p_next), p_prev, p);
+			SETPCB(tp, p_next, p);
+		}
+		tp = p;
+	}
+
+	return tp;
+}
+
+/***************************************************************
+ *  semdHead - Returns the Next Waiter of a Descriptor
+ ***************************************************************/
+static pcb_PTR semdHead(semd_PTR semd) {
+	return semd->s_byPrio ? semd->s_procQ : headProcQ(semd->s_procQ);
+}
+
+/***************************************************************
+ *  dequeueSemd - Unblocks a Process of a Known Descriptor
+ *
+ *  This function takes `p` off the queue of `semd` through its 
+ *  ownership tag and, if the queue empties, releases `semd` in 
+ *  place through its `s_pprev` link: no lookup and no search.
+ *
+ *  Parameters:
+ *    - semd: Pointer to the descriptor.
+ *    - p:    PCB in the queue of `semd`.
+ *
+ *  Returns:
+ *    - `p`, no longer blocked.
+ ***************************************************************/
+static pcb_PTR dequeueSemd(semd_PTR semd, pcb_PTR p) {
+	if (semd->s_byPrio)
+		heapOut(semd, p);
+	else
+		outProcQUnchecked(&(semd->s_procQ), p);
+
+	/* The process is no longer blocked */
+#ifdef PHASE1_ACCT
+	recordSemWait(semd, p);
+#endif
+	TRACE_EVENT(TR_UNBLOCK, p, p->p_semAdd);
+	p->p_semAdd = NULL;
+	p->p_semd = NILLINK;
+
+	/* If the queue becomes empty, remove the semaphore from ASL */
+	if (emptyProcQ(semd->s_procQ))
+		releaseSemd(semd);
+
+	return p;
+}
+
+
+/***************************************************************
+ *  blockOn - insertBlocked and insertBlockedPrio
+ *
+ *  Parameters:
+ *    - semAdd: Pointer to the semaphore address.
+ *    - p:      Pointer to the PCB to be blocked.
+ *    - byPrio: Order the queue by priority if it is empty.
+ *
+ *  Returns:
+ *    - As `insertBlocked`.
+ ***************************************************************/
+static int blockOn(int *semAdd, pcb_PTR p, int byPrio) {
+	semd_PTR semdIns;
+	semdlink_t *semdLoc;
+
+	/* Case 1: Invalid input */
+	if (NULL == p || NULL == semAdd) return TRUE;
+
+	LOCK(semLock(semAdd));
+
+	/* Device semaphores have their own descriptor */
+	semdIns = devSemd(semAdd);
+
+	/* Otherwise, locate the correct position in the ASL */
+	if (NULL == semdIns) {
+		semdLoc = traverseASL(semAdd);
+		semdIns = activeSemd(semdLoc, semAdd);
+
+#ifdef ASL_HYSTERESIS
+		/* An inactive descriptor of semAdd becomes active again as it is */
+		if (NULL != semdIns && emptyProcQ(semdIns->s_procQ)) {
+			unparkSemd(semdIns);
+			semdCache.sc_hits++;
+		}
+#endif
+
+		/* Case 2: Semaphore is not active yet, allocate a new descriptor */
+		if (NULL == semdIns)
+			semdIns = allocSemd(semdLoc, semAdd);
+	}
+
+	/* Associate process with the semaphore and add it to its queue, 
+	 * unless no free semaphore descriptors were available (Case 3) */
+	if (NULL != semdIns) {
+		p->p_semAdd = semAdd;
+		SETSEMD(p, p_semd, semdIns);
+
+		/* The first waiter chooses the order of the queue */
+		if (emptyProcQ(semdIns->s_procQ))
+			semdIns->s_byPrio = byPrio;
+		if (semdIns->s_byPrio)
+			heapIn(semdIns, p);
+		else
+			insertProcQUnchecked(&(semdIns->s_procQ), p);
+		TRACE_EVENT(TR_BLOCK, p, semAdd);
+	}
+
+	UNLOCK(semLock(semAdd));
+	return (NULL == semdIns);
+}
+
+/***************************************************************
+ *  insertBlocked - Inserts a Process into a Semaphore's Queue
+ *
+ *  This function blocks a process (`p`) on the given semaphore (`semAdd`). 
+ *  If the semaphore is already active, `p` is inserted into its queue.
+ *  Otherwise, a new semaphore descriptor is allocated from `semdFree_h`.
+ *  A registered device semaphore always uses its own descriptor.
+ *
+ *  - A queue that was empty becomes FIFO, in O(1) per insertion; 
+ *    a priority ordered queue (see `insertBlockedPrio`) stays so.
+ *
+ *  Parameters:
+ *    - semAdd: Pointer to the semaphore address.
+ *    - p: Pointer to the PCB to be blocked.
+ *
+ *  Returns:
+ *    - FALSE (0) if successful.
+ *    - TRUE (1) if `p` is NULL, `semAdd` is NULL, or if no free semaphore 
+ *      descriptors are available.
+ ***************************************************************/
+int insertBlocked(int *semAdd, pcb_PTR p) {
+	STAT_ENTER(ST_INSERTBLOCKED)
+	return blockOn(semAdd, p, FALSE);
+}
 
-	return FALSE;
+/***************************************************************
+ *  insertBlockedPrio - Inserts a Process into a Priority Ordered Queue
+ *
+ *  As `insertBlocked`, but a queue that was empty is ordered by 
+ *  priority: `removeBlocked` and `headBlocked` then give the 
+ *  waiter with the lowest `p_prio`, the earliest among equals. 
+ *  A FIFO queue that already has waiters stays FIFO.
+ *
+ *  - The queue is a pairing heap through `p_heapChild`, `p_next` 
+ *    and `p_prev`: insertion is O(1), removals O(log n) amortized.
+ *  - The priority of a waiter changes only through `setBlockedPrio` 
+ *    (or `setPriority`, which calls it), so that it keeps its place.
+ *
+ *  Parameters:
+ *    - semAdd: Pointer to the semaphore address.
+ *    - p: Pointer to the PCB to be blocked.
+ *
+ *  Returns:
+ *    - As `insertBlocked`.
+ ***************************************************************/
+int insertBlockedPrio(int *semAdd, pcb_PTR p) {
+	STAT_ENTER(ST_INSERTBLOCKEDPRIO)
+	return blockOn(semAdd, p, TRUE);
 }
 
 /***************************************************************
@@ -134,6 +845,10 @@ int insertBlocked(int *semAdd, pcb_PTR p) {
  *  This function removes and returns the first PCB from the 
  *  queue associated with `semAdd`.
  *
+ *  - This is the V path: one lookup (`findSemd`), then the head 
+ *    is unlinked and the descriptor released with no further 
+ *    search (`dequeueSemd`).
+ *
  *  Parameters:
  *    - semAdd: Pointer to the semaphore address.
  *
@@ -142,7 +857,55 @@ int insertBlocked(int *semAdd, pcb_PTR p) {
  *    - NULL if the semaphore is inactive or its queue is empty.
  ***************************************************************/
 pcb_PTR removeBlocked(int *semAdd) {
-	return outBlocked(headBlocked(semAdd));
+	semd_PTR semdLoc;
+	pcb_PTR p = NULL;
+	STAT_ENTER(ST_REMOVEBLOCKED)
+
+	LOCK(semLock(semAdd));
+	semdLoc = findSemd(semAdd);
+
+	/* Nothing is blocked on an inactive semaphore */
+	if (NULL != semdLoc && !emptyProcQ(semdLoc->s_procQ))
+		p = dequeueSemd(semdLoc, semdHead(semdLoc));
+
+	UNLOCK(semLock(semAdd));
+	return p;
+}
+
+/***************************************************************
+ *  lockedDequeue - Unblocks a Process under its Semaphore's Lock
+ *
+ *  Parameters:
+ *    - semAdd: Semaphore `p` was seen blocked on.
+ *    - p:      PCB to be unblocked.
+ *
+ *  Returns:
+ *    - `p`, no longer blocked.
+ *    - NULL if, by the time the lock was taken, `p` was no longer 
+ *      blocked on `semAdd` (only possible with `PHASE1_SMP`).
+ ***************************************************************/
+static pcb_PTR lockedDequeue(int *semAdd, pcb_PTR p) {
+	LOCK(semLock(semAdd));
+	if (p->p_semAdd == semAdd)
+		dequeueSemd(GETSEMD(p, p_semd), p);
+	else
+		p = NULL;
+	UNLOCK(semLock(semAdd));
+
+	return p;
+}
+
+/***************************************************************
+ *  outBlockedUnchecked - outBlocked for Trusted Callers
+ *
+ *  Requires `p` to be non-NULL and blocked on a semaphore.
+ ***************************************************************/
+pcb_PTR outBlockedUnchecked(pcb_PTR p) {
+	STAT_ENTER(ST_OUTBLOCKED)
+	REQUIRE(NULL != p && NILLINK != p->p_semd);
+
+	/* The descriptor is known: remove the process from its queue */
+	return lockedDequeue(p->p_semAdd, p);
 }
 
 /***************************************************************
@@ -150,44 +913,66 @@ pcb_PTR removeBlocked(int *semAdd) {
  *
  *  This function removes a specific PCB (`p`) from its semaphore queue.
  *  If the process queue becomes empty, the semaphore descriptor is returned 
- *  to the free list (`semdFree_h`).
+ *  to the free list (`semdFree_h`), unless it is a device semaphore's 
+ *  or it is kept as an inactive entry (`ASL_HYSTERESIS`).
+ *
+ *  - The descriptor is reached through `p->p_semd` and removal from 
+ *    its queue uses the queue ownership tag, so neither the ASL nor 
+ *    the semaphore queue is searched (O(1)).
  *
  *  Parameters:
  *    - p: Pointer to the PCB to be removed.
  *
  *  Returns:
  *    - Pointer to the removed PCB.
- *    - NULL if `p` is NULL, not blocked, or if the semaphore queue is empty.
+ *    - NULL if `p` is NULL or not blocked.
  ***************************************************************/
 pcb_PTR outBlocked(pcb_PTR p) {
-	semd_PTR semdLoc, semdCurr;
-	pcb_PTR pcbRm;
-
 	/* Return NULL if process is invalid or not blocked */
-	if (NULL == p || NULL == p->p_semAdd) return NULL;
+	if (NULL == p || NILLINK == p->p_semd) return NULL;
 
-	/* Find the semaphore in the ASL */
-    semdLoc = traverseASL(p->p_semAdd);
-	semdCurr = semdLoc->s_next;
+	return outBlockedUnchecked(p);
+}
+
+/***************************************************************
+ *  setBlockedPrio - Changes the Priority of a Possibly Blocked PCB
+ *
+ *  A PCB waiting in a priority ordered queue is unlinked from the 
+ *  heap and linked back with its new priority, under the semaphore's 
+ *  lock, in O(log n) amortized; it then comes after the waiters 
+ *  of equal priority. It never leaves the queue, so its wait time 
+ *  keeps accumulating and no trace events are emitted. Any other 
+ *  PCB just takes the new priority. Priorities outside [HIGHPRIO, 
+ *  LOWPRIO] are clamped to that range.
+ *
+ *  Parameters:
+ *    - p:    PCB whose priority changes.
+ *    - prio: New priority.
+ ***************************************************************/
+void setBlockedPrio(pcb_PTR p, int prio) {
+	int *semAdd;
+	semd_PTR semd;
+	STAT_ENTER(ST_SETBLOCKEDPRIO)
 
-	/* Check if the semaphore exists and has processes */
-    if (semdCurr->s_semAdd != p->p_semAdd || emptyProcQ(semdCurr->s_procQ)) return NULL;
+	if (NULL == p) return;
 
-	/* Check if the semaphore exists and has processes */
-    pcbRm = outProcQ(&(semdCurr->s_procQ), p);
-    
-	/* If the queue becomes empty, remove the semaphore from ASL */
-    if (NULL != pcbRm && emptyProcQ(semdCurr->s_procQ)) {
-        pcbRm->p_semAdd = NULL;
+	prio = MAX(HIGHPRIO, MIN(prio, LOWPRIO));
 
-		/* Remove semaphore from ASL and return it to the free list */
-		semdLoc->s_next = semdCurr->s_next;
-		semdCurr->s_procQ = mkEmptyProcQ();
-		semdCurr->s_next = semdFree_h;
-		semdFree_h = semdCurr;
-    }
-    
-    return pcbRm;
+	semAdd = p->p_semAdd;
+	if (NULL == semAdd) {
+		p->p_prio = prio;
+		return;
+	}
+
+	LOCK(semLock(semAdd));
+	semd = GETSEMD(p, p_semd);
+	if (p->p_semAdd == semAdd && NULL != semd && semd->s_byPrio) {
+		heapUnlink(semd, p);
+		p->p_prio = prio;
+		heapLink(semd, p);
+	} else
+		p->p_prio = prio;
+	UNLOCK(semLock(semAdd));
 }
 
 /***************************************************************
@@ -205,18 +990,75 @@ pcb_PTR outBlocked(pcb_PTR p) {
  ***************************************************************/
 pcb_PTR headBlocked(int *semAdd) {
 	semd_PTR semdLoc;
-	pcb_PTR pcbRet;
+	pcb_PTR p = NULL;
+	STAT_ENTER(ST_HEADBLOCKED)
 
-	semdLoc = traverseASL(semAdd)->s_next;
+	LOCK(semLock(semAdd));
+	semdLoc = findSemd(semAdd);
 
-	/* Check if semaphore is active and has processes */
-	if (semdLoc->s_semAdd != semAdd || emptyProcQ(semdLoc->s_procQ)) return NULL;
+	/* Check if semaphore is active, then take its first process */
+	if (NULL != semdLoc)
+		p = semdHead(semdLoc);
 
-	pcbRet = headProcQ(semdLoc->s_procQ);
-	pcbRet->p_semAdd = semAdd;
+	UNLOCK(semLock(semAdd));
+	return p;
+}
 
-	/* Return the first process in the queue without removing it */
-	return pcbRet;
+/***************************************************************
+ *  removeAllBlocked - Detaches a Semaphore's Whole Queue
+ *
+ *  This function unblocks every process waiting on `semAdd` at 
+ *  once: the semaphore's process queue is detached in a single 
+ *  step and its descriptor is returned to the free list.
+ *
+ *  - Costs one ASL lookup regardless of the number of waiters 
+ *    (plus one step per waiter with `PHASE1_ACCT`).
+ *  - The returned PCBs still carry their semaphore fields and 
+ *    ownership tag; pass the queue's tail pointer to 
+ *    `unblockProcQ` before using it with the procQ functions.
+ *
+ *  Parameters:
+ *    - semAdd: Pointer to the semaphore address.
+ *
+ *  Returns:
+ *    - Tail pointer of the detached process queue (FIFO order 
+ *      preserved, or priority order, at O(n log n), for a queue 
+ *      filled by `insertBlockedPrio`).
+ *    - An empty queue if the semaphore is inactive.
+ ***************************************************************/
+pcb_PTR removeAllBlocked(int *semAdd) {
+	semd_PTR semdLoc;
+	pcb_PTR tp;
+#ifdef PHASE1_ACCT
+	pcb_PTR p;
+#endif
+	STAT_ENTER(ST_REMOVEALLBLOCKED)
+
+	LOCK(semLock(semAdd));
+	semdLoc = findSemd(semAdd);
+
+	/* Nothing is blocked on an inactive semaphore */
+	if (NULL == semdLoc || emptyProcQ(semdLoc->s_procQ)) {
+		UNLOCK(semLock(semAdd));
+		return mkEmptyProcQ();
+	}
+
+	/* Detach the queue, in unblocking order, then free the descriptor once */
+	tp = semdLoc->s_byPrio ? heapToProcQ(semdLoc) : semdLoc->s_procQ;
+#ifdef PHASE1_ACCT
+	/* Every waiter's stay ends here */
+	p = tp;
+	do {
+		p = GETPCB(p, p_next);
+		ACCT_DEQUEUE(p);
+		recordSemWait(semdLoc, p);
+	} while (p != tp);
+#endif
+	TRACE_EVENT(TR_UNBLOCKALL, tp, semAdd);
+	releaseSemd(semdLoc);
+	UNLOCK(semLock(semAdd));
+
+	return tp;
 }
 
 /***************************************************************
@@ -233,34 +1075,139 @@ pcb_PTR headBlocked(int *semAdd) {
  *  - Two dummy nodes are added at the beginning and end of 
  *    the ASL for efficient traversal and avoid the meomry loss:
  *      - Head Dummy Node: `s_semAdd = 0`
- *      - Tail Dummy Node: `s_semAdd = MAX_INT`
+ *      - Tail Dummy Node: `s_semAdd = MAXSEMADD`, above any 
+ *        semaphore address on either target
+ *  - With `ASL_HASH`, every bucket starts as an empty chain 
+ *    and the dummy nodes are not used.
  *
  *  Parameters:
  *    - None
  ***************************************************************/
 void initASL(void) {
 	int i;
-	/* Static array of semaphore descriptors */
-	static semd_t semdTable[MAXPROC + DUMMYVARCOUNT];
+	STAT_ENTER(ST_INITASL)
 
 	/* Initialize both ASL and Free List heads */	
-	semdFree_h = semd_h = NULL;																													
+	semdFree_h = NULL;
+	devSem_h = NULL;
+#ifdef ASL_HYSTERESIS
+	semdLru_h = semdLru_t = NULL;
+	semdCache.sc_parks = semdCache.sc_hits = semdCache.sc_reclaims = 0;
+	semdCache.sc_inactive = 0;
+#endif																													
 
 	/* Step 1: Initialize the Free List */
-	for (i = 0; i < MAXPROC; ++i)
+	for (i = 0; i < MAXSEMD; ++i) {
 		/* Each descriptor points to the next in the Free List */
-		semdTable[i] = (semd_t) {&semdTable[i + 1], (int*) NULL, mkEmptyProcQ()};
+		SETSEMD(&semdPool[i], s_next, &semdPool[i + 1]);
+		semdPool[i].s_semAdd = NULL;
+		semdPool[i].s_procQ = mkEmptyProcQ();
+		semdPool[i].s_pprev = NULL;
+	}
 
 	/* Last element of the Free List should point to NULL */
-	semdTable[MAXPROC - 1].s_next = NULL;		
+	semdPool[MAXSEMD - 1].s_next = NILLINK;		
 	/* Set the head of the Free List to the first descriptor */									
-	semdFree_h = &semdTable[0];														
+	semdFree_h = &semdPool[0];														
+
+#ifdef PHASE1_ACCT
+	/* Forget every semaphore's histogram */
+	for (i = 0; i < SEMHISTSIZE; ++i) {
+		semHistKey[i] = NULL;
+		resetHist(&semHistTable[i]);
+	}
+	resetHist(&semHistOther);
+	INITLOCK(&semHistLock);
+#endif
+
+#ifdef PHASE1_SMP
+	INITLOCK(&semdFreeLock);
+	for (i = 0; i < ASLHASHSIZE; ++i)
+		INITLOCK(&semdHashLock[i]);
+#endif
 
+#ifdef ASL_HASH
+	/* Step 2: Empty every bucket of the hashed ASL */
+	for (i = 0; i < ASLHASHSIZE; ++i)
+		semdHash_h[i] = NILLINK;
+#else
 	/* Step 2: Initialize Dummy Nodes for ASL */
 	/* Dummy Head Node (s_semAdd = 0) */
-	semdTable[MAXPROC] = (semd_t) {&semdTable[MAXPROC + 1], (int*) 0, mkEmptyProcQ()};
-	/* Dummy Tail Node (s_semAdd = MAX_INT) */
-	semdTable[MAXPROC + 1] = (semd_t) {NULL, (int*) MAX_INT, mkEmptyProcQ()};
+	SETSEMD(&semdPool[MAXSEMD], s_next, &semdPool[MAXSEMD + 1]);
+	semdPool[MAXSEMD].s_semAdd = (int*) 0;
+	semdPool[MAXSEMD].s_procQ = mkEmptyProcQ();
+	semdPool[MAXSEMD].s_pprev = NULL;
+	/* Dummy Tail Node (s_semAdd = MAXSEMADD) */
+	semdPool[MAXSEMD + 1].s_next = NILLINK;
+	semdPool[MAXSEMD + 1].s_semAdd = MAXSEMADD;
+	semdPool[MAXSEMD + 1].s_procQ = mkEmptyProcQ();
+	semdPool[MAXSEMD + 1].s_pprev = &semdPool[MAXSEMD].s_next;
 	/* Set the head of ASL to the Dummy Head Node */
-	semd_h = &semdTable[MAXPROC];
-}
\ No newline at end of file
+	semd_h = &semdPool[MAXSEMD];
+#endif
+}
+
+/***************************************************************
+ *  registerDevSems - Registers the Device Semaphore Array
+ *
+ *  This function makes the `DEVSEMNUM` semaphores of `devSems` 
+ *  bypass the ASL: from now on each of them is mapped by index 
+ *  to a preallocated descriptor that is never freed, so blocking 
+ *  and unblocking on them costs O(1).
+ *
+ *  - Call it after `initASL` and before any process blocks on 
+ *    one of these semaphores; passing NULL unregisters them.
+ *  - `initASL` unregisters the array.
+ *
+ *  Parameters:
+ *    - devSems: Array of `DEVSEMNUM` device semaphores, indexed 
+ *      as the kernel lays them out (pseudo-clock at `CLOCKSEM`).
+ ***************************************************************/
+void registerDevSems(int devSems[]) {
+	int i;
+	STAT_ENTER(ST_REGISTERDEVSEMS)
+
+	devSem_h = devSems;
+
+	for (i = 0; i < DEVSEMNUM; ++i) {
+		devSemdTable[i].s_next = NILLINK;
+		devSemdTable[i].s_semAdd = (NULL == devSems) ? NULL : &devSems[i];
+		devSemdTable[i].s_procQ = mkEmptyProcQ();
+		devSemdTable[i].s_pprev = NULL;
+#ifdef PHASE1_ACCT
+		resetHist(&devSemHist[i]);
+		devSemdTable[i].s_hist = &devSemHist[i];
+#endif
+		INITLOCK(&devSemLock[i]);
+	}
+}
+
+#ifdef PHASE1_ACCT
+/***************************************************************
+ *  semWaitHist - Returns the Wait Histogram of a Semaphore
+ *
+ *  - A device semaphore's histogram covers every wait since 
+ *    `registerDevSems`; any other semaphore's covers every wait 
+ *    since `initASL`, however often its descriptor was freed and 
+ *    reallocated in between.
+ *  - The waits of semaphores that found no slot are in the shared 
+ *    histogram, returned for a NULL `semAdd`.
+ *
+ *  Parameters:
+ *    - semAdd: Pointer to the semaphore address, or NULL.
+ *
+ *  Returns:
+ *    - Pointer to the histogram of the semaphore.
+ *    - NULL if no process ever blocked on it, or it has no slot.
+ ***************************************************************/
+waithist_PTR semWaitHist(int *semAdd) {
+	semd_PTR semdLoc;
+
+	if (NULL == semAdd) return &semHistOther;
+
+	semdLoc = devSemd(semAdd);
+	if (NULL != semdLoc) return semdLoc->s_hist;
+
+	return semHist(semAdd, FALSE);
+}
+#endif
@@ -0,0 +1,71 @@
+/******************************* bitmap.c ************************************
+ *
+ *  Module: Bit Manipulation Helpers
+ *
+ *  This module implements the bit scanning primitives used by the 
+ *  bitmap-indexed data structures of phase 1 (e.g., the multi-level 
+ *  ready queue).
+ *
+ *  The MIPS I target has no count-leading/trailing-zeros instruction, 
+ *  and the kernel is linked without libgcc, so find-first-set is done 
+ *  in software: the lowest set bit is isolated and multiplied by a 
+ *  de Bruijn constant, whose top five bits then index a 32-entry table. 
+ *  This takes constant time regardless of which bit is set.
+ *
+ *****************************************************************************/
+
+#include "../h/bitmap.h"
+
+/* Bit position of each value of the top five bits of (bit * DEBRUIJN32) */
+#define DEBRUIJN32		0x077CB531U
+HIDDEN const int deBruijnBit[32] = {
+	0, 1, 28, 2, 29, 14, 24, 3, 30, 22, 20, 15, 25, 17, 4, 8,
+	31, 27, 13, 23, 21, 19, 16, 7, 26, 12, 18, 6, 11, 5, 10, 9
+};
+
+/***************************************************************
+ *  firstSetBit - Finds the Lowest Set Bit of a Word
+ *
+ *  Parameters:
+ *    - w: Word to scan.
+ *
+ *  Returns:
+ *    - Index (0 to 31) of the least significant set bit of `w`.
+ *    - -1 if `w` is 0.
+ ***************************************************************/
+int firstSetBit(unsigned int w) {
+	/* No bit set */
+	if (0 == w) return -1;
+
+	/* Isolate the lowest set bit and look up its position */
+	return deBruijnBit[((unsigned int) ((w & -w) * DEBRUIJN32)) >> 27];
+}
+
+/***************************************************************
+ *  lastSetBit - Finds the Highest Set Bit of a Word
+ *
+ *  The highest set bit is smeared into every bit below it, and 
+ *  xoring the result with itself shifted by one leaves that bit 
+ *  alone; it is then looked up as in `firstSetBit`.
+ *
+ *  Parameters:
+ *    - w: Word to scan.
+ *
+ *  Returns:
+ *    - Index (0 to 31) of the most significant set bit of `w`.
+ *    - -1 if `w` is 0.
+ ***************************************************************/
+int lastSetBit(unsigned int w) {
+	/* No bit set */
+	if (0 == w) return -1;
+
+	/* Smear the highest set bit downwards, then keep it alone */
+	w |= w >> 1;
+	w |= w >> 2;
+	w |= w >> 4;
+	w |= w >> 8;
+	w |= w >> 16;
+	w ^= w >> 1;
+
+	return deBruijnBit[((unsigned int) (w * DEBRUIJN32)) >> 27];
+}
@@ -0,0 +1,72 @@
+/******************************** host.c *************************************
+ *
+ *  Module: Host Shim
+ *
+ *  This module stands in for the uMPS3 machine when phase 1 is built 
+ *  as a host program (PHASE1_HOST, see ../h/port.h), so that its data 
+ *  structures can be run under host profilers and sanitizers:
+ *    - hostClock: the TOD clock, in microseconds since the first read;
+ *    - hostPrint: terminal 0 output, written to stdout;
+ *    - hostPanic / hostHalt: the PANIC and HALT services, which end 
+ *      the program with a failure or success exit status;
+ *    - hostCas: the CAS service (atomic compare and swap), with the 
+ *      compiler's atomic builtin;
+ *    - hostCpu: the number of the running processor, 0 unless a test 
+ *      stands in for another;
+ *    - main: calls the test program's main, renamed phase1Main.
+ *
+ *  This is the only file that includes system headers, and it includes 
+ *  no phase 1 header. cpu_t is repeated here as int.
+ *
+ *****************************************************************************/
+
+#define _POSIX_C_SOURCE 199309L
+
+#include <stdio.h>
+#include <stdlib.h>
+#include <time.h>
+
+extern void phase1Main(void);
+
+int hostCpu = 0;
+
+static int clockSet = 0;
+static struct timespec clockBase;
+
+int hostClock(void) {
+	struct timespec now;
+
+	if (!clockSet) {
+		clock_gettime(CLOCK_MONOTONIC, &clockBase);
+		clockSet = 1;
+	}
+	clock_gettime(CLOCK_MONOTONIC, &now);
+
+	return (int) ((now.tv_sec - clockBase.tv_sec) * 1000000L
+				+ (now.tv_nsec - clockBase.tv_nsec) / 1000L);
+}
+
+int hostPrint(char *str) {
+	return fputs(str, stdout) >= 0;
+}
+
+void hostPanic(void) {
+	fflush(stdout);
+	fputs("PANIC\n", stderr);
+	exit(EXIT_FAILURE);
+}
+
+unsigned int hostCas(unsigned int *atomic, unsigned int ov, unsigned int nv) {
+	return __sync_bool_compare_and_swap(atomic, ov, nv);
+}
+
+void hostHalt(void) {
+	fflush(stdout);
+	exit(EXIT_SUCCESS);
+}
+
+int main(void) {
+	phase1Main();
+	fflush(stdout);
+	return EXIT_SUCCESS;
+}
@@ -0,0 +1,409 @@
+/*********************************P1BENCH.C******************************
+ *
+ *	Benchmark program for the modules ASL and pcbQueues (phase 1).
+ *
+ *	Times the phase 1 primitives with the TOD clock and prints one 
+ *		line per measurement on terminal 0, in the form
+ *
+ *			op,n,reps,ticks
+ *
+ *		where n is the size the operation ran at (queue length, 
+ *		number of active semaphores, number of children, ...), 
+ *		reps the number of times it ran and ticks the total 
+ *		elapsed TOD time (STCK units); ticks / reps is the cost 
+ *		of one operation. Operations named "a+b" time a followed 
+ *		by b, which restores the structure to its size n.
+ *
+ *	Every benchmark runs at sizes 2, 8, 32, ... up to the pool size.
+ *		Build with "make bench"; the pool sizes follow the same 
+ *		MAXPROC and MAXSEMD settings as the test kernel, and 
+ *		"make benchsweep" builds one benchmark kernel per MAXPROC 
+ *		of BENCHSIZES.
+ */
+
+#include "../h/const.h"
+#include "../h/types.h"
+
+#include "../h/port.h"
+#include "../h/pcb.h"
+#include "../h/asl.h"
+#include "../h/readyq.h"
+#include "../h/stats.h"
+#include "../h/termout.h"
+#include "../h/fmt.h"
+
+#define REPS		1000		/* repetitions of every timed loop */
+#define WALKREPS	100			/* repetitions of the full walks */
+#define MINSIZE		2			/* smallest size benchmarked */
+#define SIZESTEP	4			/* ratio between successive sizes */
+
+pcb_t	*procp[MAXPROC], *qa;
+int		sem[MAXSEMD];
+int		devsem[DEVSEMNUM];
+int		sink;					/* keeps the timed loops from being optimized away */
+
+
+/* This function queues a string for output on the specified terminal and 
+ * returns TRUE if it was accepted, FALSE if not (see h/termout.h) */
+unsigned int termprint(char * str, unsigned int term) {
+	return termWrite(term, str);
+}
+
+
+/* This function prints one "op,n,reps,ticks" result line on terminal0 */
+void report(char *op, int n, int reps, cpu_t ticks) {
+	char line[80];
+	char *lp;
+
+	lp = fmtstr(line, op);
+	*lp++ = ',';
+	lp = fmtuint(lp, n);
+	*lp++ = ',';
+	lp = fmtuint(lp, reps);
+	*lp++ = ',';
+	lp = fmtuint(lp, ticks);
+	*lp++ = '\n';
+	*lp = EOS;
+
+	termprint(line, 0);
+}
+
+
+/* This function prints one line of the counters dump on terminal0 */
+void printStat(char *line) {
+	termprint(line, 0);
+}
+
+
+/* This function is the per-PCB visitor of the tree walk benchmark */
+void touchPcb(pcb_PTR p, void *arg) {
+	sink += p->p_prio;
+}
+
+
+/* This function returns the size to benchmark after n, up to max */
+int nextSize(int n, int max) {
+	if (n < max && n * SIZESTEP > max)
+		return max;
+	return n * SIZESTEP;
+}
+
+
+/* This function fills qa with the first n PCBs of procp */
+void fillQueue(int n) {
+	int i;
+
+	qa = mkEmptyProcQ();
+	for (i = 0; i < n; i++)
+		insertProcQ(&qa, procp[i]);
+}
+
+
+/* This function empties qa */
+void drainQueue(void) {
+	while (!emptyProcQ(qa))
+		removeProcQ(&qa);
+}
+
+
+/* This function times WALKREPS full walks over the n PCBs of qa */
+void timeQueueWalk(char *op, int n) {
+	int r;
+	cpu_t t0, t1;
+	pcb_PTR iter;
+
+	STCK(t0);
+	for (r = 0; r < WALKREPS; r++) {
+		iter = qa;
+		do {
+			iter = GETPCB(iter, p_next);
+			sink += iter->p_prio;
+		} while (iter != qa);
+	}
+	STCK(t1);
+	report(op, n, WALKREPS, t1 - t0);
+}
+
+
+/* This function times allocPcb/freePcb cycles with n PCBs in flight */
+void benchAlloc(int n) {
+	int i, r;
+	cpu_t t0, t1;
+
+	for (i = 0; i < n; i++)
+		freePcb(procp[i]);
+
+	STCK(t0);
+	for (r = 0; r < REPS / n + 1; r++) {
+		for (i = 0; i < n; i++)
+			procp[i] = allocPcb();
+		for (i = 0; i < n; i++)
+			freePcb(procp[i]);
+	}
+	STCK(t1);
+	report("allocPcb+freePcb", n, (REPS / n + 1) * n, t1 - t0);
+
+	for (i = 0; i < n; i++)
+		procp[i] = allocPcb();
+}
+
+
+/* This function times the queue primitives on a queue of n PCBs */
+void benchProcQ(int n) {
+	int r;
+	cpu_t t0, t1;
+	pcb_PTR p, next;
+
+	fillQueue(n);
+
+	/* FIFO use: the head goes back at the tail */
+	STCK(t0);
+	for (r = 0; r < REPS; r++)
+		insertProcQ(&qa, removeProcQ(&qa));
+	STCK(t1);
+	report("removeProcQ+insertProcQ", n, REPS, t1 - t0);
+
+	STCK(t0);
+	for (r = 0; r < REPS; r++)
+		insertProcQ(&qa, outProcQ(&qa, headProcQ(qa)));
+	STCK(t1);
+	report("outProcQ_head+insertProcQ", n, REPS, t1 - t0);
+
+	/* the successor of the middle PCB is the next middle PCB */
+	for (r = 0, p = headProcQ(qa); r < n / 2; r++)
+		p = GETPCB(p, p_next);
+	STCK(t0);
+	for (r = 0; r < REPS; r++) {
+		next = GETPCB(p, p_next);
+		insertProcQ(&qa, outProcQ(&qa, p));
+		p = next;
+	}
+	STCK(t1);
+	report("outProcQ_mid+insertProcQ", n, REPS, t1 - t0);
+
+	STCK(t0);
+	for (r = 0; r < REPS; r++)
+		insertProcQ(&qa, outProcQ(&qa, qa));
+	STCK(t1);
+	report("outProcQ_tail+insertProcQ", n, REPS, t1 - t0);
+
+	drainQueue();
+}
+
+
+/* This function times the ASL primitives with n active semaphores, 
+*	each with one waiter; the timed semaphore has the highest address */
+void benchASL(int n) {
+	int i, r;
+	cpu_t t0, t1;
+	pcb_PTR p;
+
+	for (i = 0; i < n - 1; i++)
+		insertBlocked(&sem[i], procp[i]);
+
+	/* P and V on a semaphore that is not active yet */
+	p = procp[n - 1];
+	STCK(t0);
+	for (r = 0; r < REPS; r++) {
+		insertBlocked(&sem[n - 1], p);
+		removeBlocked(&sem[n - 1]);
+	}
+	STCK(t1);
+	report("insertBlocked+removeBlocked_new", n, REPS, t1 - t0);
+
+	/* P and V on an active semaphore: one waiter before and after */
+	STCK(t0);
+	for (r = 0; r < REPS; r++) {
+		insertBlocked(&sem[n - 2], p);
+		p = removeBlocked(&sem[n - 2]);
+	}
+	STCK(t1);
+	report("insertBlocked+removeBlocked_active", n, REPS, t1 - t0);
+
+	STCK(t0);
+	for (r = 0; r < REPS; r++) {
+		insertBlocked(&sem[n - 2], p);
+		outBlocked(p);
+	}
+	STCK(t1);
+	report("insertBlocked+outBlocked", n, REPS, t1 - t0);
+
+	STCK(t0);
+	for (r = 0; r < REPS; r++)
+		sink += (NULL != headBlocked(&sem[n - 2]));
+	STCK(t1);
+	report("headBlocked", n, REPS, t1 - t0);
+
+	/* P and V on a device semaphore, whatever the ASL holds */
+	registerDevSems(devsem);
+	STCK(t0);
+	for (r = 0; r < REPS; r++) {
+		insertBlocked(&devsem[CLOCKSEM], p);
+		removeBlocked(&devsem[CLOCKSEM]);
+	}
+	STCK(t1);
+	report("insertBlocked+removeBlocked_dev", n, REPS, t1 - t0);
+	registerDevSems(NULL);
+
+	for (i = 0; i < n - 1; i++)
+		removeBlocked(&sem[i]);
+}
+
+
+/* This function times the tree primitives on a parent with n children */
+void benchTree(int n) {
+	int i, r;
+	cpu_t t0, t1;
+	pcb_PTR p;
+
+	for (i = 1; i < n; i++)
+		insertChild(procp[0], procp[i]);
+
+	/* the newest child is the first one */
+	p = procp[n];
+	STCK(t0);
+	for (r = 0; r < REPS; r++) {
+		insertChild(procp[0], p);
+		removeChild(procp[0]);
+	}
+	STCK(t1);
+	report("insertChild+removeChild", n, REPS, t1 - t0);
+
+	p = procp[n / 2 + 1];
+	STCK(t0);
+	for (r = 0; r < REPS; r++)
+		insertChild(procp[0], outChild(p));
+	STCK(t1);
+	report("outChild+insertChild", n, REPS, t1 - t0);
+
+	while (!emptyChild(procp[0]))
+		removeChild(procp[0]);
+}
+
+
+/* This function times WALKREPS full walks over a queue of n PCBs */
+void benchQueueWalk(int n) {
+	fillQueue(n);
+	timeQueueWalk("walk_procq", n);
+	drainQueue();
+}
+
+
+/* This function times the allocator on a fragmented pool: all PCBs 
+*	are freed out of index order, then n are allocated. The span of 
+*	their pool indexes (reported in the ticks field of "alloc_span") 
+*	and the time of a walk over them show how well the allocator 
+*	packs them */
+void benchAllocFrag(int n) {
+	int i, lo, hi;
+	cpu_t t0, t1;
+
+	/* even PCBs in order, then odd ones in reverse */
+	for (i = 0; i < MAXPROC; i += 2)
+		freePcb(procp[i]);
+	for (i = MAXPROC - 1 - MAXPROC % 2; i > 0; i -= 2)
+		freePcb(procp[i]);
+
+	STCK(t0);
+	for (i = 0; i < n; i++)
+		procp[i] = allocPcb();
+	STCK(t1);
+	report("allocPcb_frag", n, n, t1 - t0);
+
+	lo = MAXPROC;
+	hi = 0;
+	for (i = 0; i < n; i++) {
+		lo = MIN(lo, (int) (pcbToHandle(procp[i]) & PIDINDEXMASK));
+		hi = MAX(hi, (int) (pcbToHandle(procp[i]) & PIDINDEXMASK));
+	}
+	report("alloc_span", n, 1, hi - lo + 1);
+
+	fillQueue(n);
+	timeQueueWalk("walk_frag", n);
+	drainQueue();
+
+	for (i = n; i < MAXPROC; i++)
+		procp[i] = allocPcb();
+}
+
+
+/* This function times WALKREPS walks over a tree of n PCBs, all 
+*	children of procp[0] */
+void benchTreeWalk(int n) {
+	int i, r;
+	cpu_t t0, t1;
+
+	for (i = 1; i < n; i++)
+		insertChild(procp[0], procp[i]);
+
+	STCK(t0);
+	for (r = 0; r < WALKREPS; r++)
+		walkSubtree(procp[0], touchPcb, NULL);
+	STCK(t1);
+	report("walk_tree", n, WALKREPS, t1 - t0);
+
+	while (!emptyChild(procp[0]))
+		removeChild(procp[0]);
+}
+
+
+void main() {
+	int i, n;
+
+	initTermOut();
+	initPcbs();
+	initASL();
+	for (i = 0; i < MAXPROC; i++)
+		procp[i] = allocPcb();
+
+	resetStats();
+
+	/* build configuration, then the result table */
+	termprint("# config,maxproc,maxsemd,aslbuckets\n", 0);
+#ifdef ASL_HASH
+	report("config_hash", MAXPROC, MAXSEMD, ASLHASHSIZE);
+#else
+	report("config_list", MAXPROC, MAXSEMD, 0);
+#endif
+#ifdef PCB_BITMAPALLOC
+	report("config_pcbbitmap", MAXPROC, MAXSEMD, 0);
+#else
+	report("config_pcblist", MAXPROC, MAXSEMD, 0);
+#endif
+#ifdef PHASE1_SMP
+	report("config_smp", MAXPROC, MAXSEMD, NCPU);
+#endif
+	termprint("# op,n,reps,ticks\n", 0);
+
+	for (n = MINSIZE; n <= MAXPROC; n = nextSize(n, MAXPROC))
+		benchAlloc(n);
+
+	for (n = MINSIZE; n <= MAXPROC; n = nextSize(n, MAXPROC))
+		benchAllocFrag(n);
+
+	for (n = MINSIZE; n <= MAXPROC; n = nextSize(n, MAXPROC))
+		benchProcQ(n);
+
+	for (n = MINSIZE; n <= MIN(MAXPROC, MAXSEMD); n = nextSize(n, MIN(MAXPROC, MAXSEMD)))
+		benchASL(n);
+
+	/* one spare PCB is cycled in and out of the children */
+	for (n = MINSIZE; n < MAXPROC; n = nextSize(n, MAXPROC - 1))
+		benchTree(n);
+
+	/* PCB layout: queue and tree walks over the whole pool */
+	benchQueueWalk(MAXPROC);
+	benchTreeWalk(MAXPROC);
+
+	/* per-operation counters, when built with STATS=yes */
+	dumpStats(printStat);
+
+#ifdef ASL_HYSTERESIS
+	/* inactive descriptor cache, when built with ASLCACHE=yes */
+	termprint("# semdcache,parks,hits,reclaims\n", 0);
+	report("semdcache", semdCache.sc_parks, semdCache.sc_hits, semdCache.sc_reclaims);
+#endif
+
+	termprint("# done\n", 0);
+	termFlush(0);
+}
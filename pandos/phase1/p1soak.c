@@ -0,0 +1,526 @@
+/*********************************P1SOAK.C*******************************
+ *
+ *	Soak program for the modules ASL, pcbQueues and readyQueue 
+ *		(phase 1).
+ *
+ *	Runs a long, deterministic random mix of operations on the 
+ *		phase 1 structures: PCB alloc/free, ready queue churn and 
+ *		priority changes, P/V over semaphores with a skewed 
+ *		popularity (low numbered semaphores are much hotter), 
+ *		FIFO or priority ordered, outBlocked, process tree growth, 
+ *		adoption of whole child lists and subtree teardown.
+ *
+ *	Every CHECKEVERY operations the PCB fields are checked against 
+ *		the program's own bookkeeping, and the run panics on the 
+ *		first mismatch. At the end one line per operation is 
+ *		printed on terminal 0, in the form
+ *
+ *			soak,op,count,ticks,maxticks
+ *
+ *		where count is the number of operations that found 
+ *		something to work on, ticks their total and maxticks the 
+ *		worst single one (STCK units). Only the phase 1 call of an 
+ *		operation is timed: the choice of its PCB or semaphore 
+ *		comes before the clock starts. A "check" line gives the 
+ *		time of the invariant checks, and the "total" line the 
+ *		time of the whole run without them. Built with ACCT=yes, 
+ *		the wait histogram of every ready queue level follows.
+ *
+ *	Traces: built with SOAK_RECORD every operation is also printed, 
+ *		before it runs, as a "trace,{op, arg}," line; built with 
+ *		SOAK_REPLAY the operations are read from soaktrace.h, a 
+ *		list of "{op, arg}," lines (a recorded trace with the 
+ *		"trace," prefixes removed), instead of being generated.
+ *
+ *	Build with "make soak"; see the Makefile for SOAKOPS, SOAKSEED 
+ *		and SOAKMODE.
+ */
+
+#include "../h/const.h"
+#include "../h/types.h"
+
+#include "../h/port.h"
+#include "../h/pcb.h"
+#include "../h/asl.h"
+#include "../h/readyq.h"
+#include "../h/acct.h"
+#include "../h/termout.h"
+#include "../h/fmt.h"
+
+#ifndef SOAKOPS
+#define SOAKOPS		100000		/* operations of a generated run */
+#endif
+#ifndef SOAKSEED
+#define SOAKSEED	0x2545F491	/* seed of the generator */
+#endif
+#define CHECKEVERY	1000		/* operations between invariant checks */
+#define NSEMS		MAXSEMD		/* semaphores the workload blocks on */
+
+/* operations */
+#define OP_ALLOC	0
+#define OP_FREE		1
+#define OP_READY	2
+#define OP_RUN		3
+#define OP_PRIO		4
+#define OP_P		5
+#define OP_V		6
+#define OP_OUT		7
+#define OP_CHILD	8
+#define OP_KILL		9
+#define OP_ADOPT	10
+#define NOPS		11
+
+/* share of each operation in the generated mix, out of MIXTOTAL */
+#define MIXTOTAL	100
+HIDDEN int opMix[NOPS] = {14, 6, 18, 16, 4, 16, 16, 4, 4, 1, 1};
+
+HIDDEN char *opNames[NOPS] = {
+	"alloc", "free", "ready", "run", "prio", "P", "V", "out", "child", "kill",
+	"adopt"
+};
+
+/* state of a slot */
+#define S_FREE		0			/* no PCB allocated */
+#define S_IDLE		1			/* allocated, in no queue */
+#define S_READY		2			/* on the ready queue */
+#define S_BLOCKED	3			/* on a semaphore */
+#define NSTATES		4
+
+typedef struct traceop_t {
+	int				t_op;		/* operation */
+	unsigned int	t_arg;		/* random argument of the operation */
+} traceop_t;
+
+#ifdef SOAK_REPLAY
+HIDDEN traceop_t soakTrace[] = {
+#include "soaktrace.h"
+};
+#define TRACELEN	(sizeof(soakTrace) / sizeof(soakTrace[0]))
+#endif
+
+pcb_PTR		slot[MAXPROC];		/* PCB of each slot: slot i holds pcbPool[i] */
+int			state[MAXPROC];		/* state of each slot */
+int			count[NSTATES];		/* number of slots in each state */
+int			children[MAXPROC];	/* children of each slot, while checking */
+int			sem[NSEMS];
+int			semWaiters[NSEMS];	/* PCBs blocked on each semaphore */
+int			semByPrio[NSEMS];	/* TRUE if its queue is priority ordered */
+readyq_t	rq;
+unsigned int seed = SOAKSEED;
+
+/* per-operation results, and the clock readings around the timed call */
+unsigned int opCount[NOPS];
+cpu_t		opTicks[NOPS], opMax[NOPS];
+cpu_t		t0, t1;
+
+/* Runs CALL, the phase 1 call of an operation, between the clock readings */
+#define TIMED(CALL)		(STCK(t0), (CALL), STCK(t1))
+
+char		errbuf[128];		/* contains reason for failing */
+
+
+/* This function queues a string for output on the specified terminal and 
+ * returns TRUE if it was accepted, FALSE if not (see h/termout.h) */
+unsigned int termprint(char * str, unsigned int term) {
+	return termWrite(term, str);
+}
+
+
+/* This function places the specified character string in errbuf and
+*	causes the string to be written out to terminal0.  After this is done
+*	the system shuts down with a panic message */
+void adderrbuf(char *strp) {
+	char *ep = errbuf;
+	char *tstrp = strp;
+	
+	while ((*ep++ = *strp++) != '\0');
+	
+	termprint(tstrp, 0);
+	termFlush(0);
+		
+	PANIC();
+}
+
+
+/* This function returns the next number of the xorshift32 generator */
+unsigned int nextRand(void) {
+	seed ^= seed << 13;
+	seed ^= seed >> 17;
+	seed ^= seed << 5;
+	return seed;
+}
+
+
+/* This function returns the operation r selects in the generated mix */
+int pickOp(unsigned int r) {
+	int op = 0;
+	int acc = opMix[0];
+
+	r %= MIXTOTAL;
+	while (acc <= (int) r)
+		acc += opMix[++op];
+	return op;
+}
+
+
+/* This function returns the first slot in state s at or after the 
+*	one arg selects, or -1 if no slot is in state s */
+int pickSlot(unsigned int arg, int s) {
+	int i, n;
+
+	if (0 == count[s]) return -1;
+
+	for (i = arg % MAXPROC, n = 0; n < MAXPROC; i = (i + 1) % MAXPROC, n++)
+		if (state[i] == s)
+			return i;
+	return -1;
+}
+
+
+/* This function returns the semaphore arg selects: the smaller of two 
+*	uniform picks, so that low indexes are the popular ones */
+int pickSem(unsigned int arg) {
+	return MIN((arg & 0xFFFF) % NSEMS, (arg >> 16) % NSEMS);
+}
+
+
+/* This function returns the slot of an allocated PCB: its index in the 
+*	pool, which its handle carries */
+int indexOf(pcb_PTR p) {
+	return (int) (pcbToHandle(p) & PIDINDEXMASK);
+}
+
+
+/* This function returns the slot holding p, or -1 */
+int slotOf(pcb_PTR p) {
+	int i = indexOf(p);
+
+	if (i < MAXPROC && state[i] != S_FREE && slot[i] == p)
+		return i;
+	return -1;
+}
+
+
+/* This function moves slot i to state s */
+void setState(int i, int s) {
+	count[state[i]]--;
+	count[s]++;
+	state[i] = s;
+}
+
+
+/* This function is the subtree teardown visitor: it takes p off 
+*	whatever queue holds it and frees it */
+void killPcb(pcb_PTR p, void *arg) {
+	int i = slotOf(p);
+
+	if (i < 0)
+		adderrbuf("kill: subtree PCB not allocated   ");
+	if (state[i] == S_BLOCKED) {
+		semWaiters[p->p_semAdd - sem]--;
+		if (outBlocked(p) != p)
+			adderrbuf("kill: outBlocked failed on a blocked PCB   ");
+	}
+	if (state[i] == S_READY && outReadyQ(&rq, p) != p)
+		adderrbuf("kill: outReadyQ failed on a ready PCB   ");
+
+	freePcb(p);
+	setState(i, S_FREE);
+}
+
+
+/* This function checks that p, just removed from the priority ordered 
+*	semaphore s, had the highest priority of its waiters */
+void checkPrioOrder(int s, pcb_PTR p) {
+	int i;
+
+	for (i = 0; i < MAXPROC; i++)
+		if (state[i] == S_BLOCKED && slot[i] != p && slot[i]->p_semAdd == &sem[s]
+			&& slot[i]->p_prio < p->p_prio)
+			adderrbuf("V: removeBlocked passed over a higher priority waiter   ");
+}
+
+
+/* This function runs operation op with argument arg, timing its phase 1 
+*	call with TIMED; it returns FALSE if the operation found nothing to 
+*	work on, and so made no call */
+int runOp(int op, unsigned int arg) {
+	int i, j, byPrio;
+	pcb_PTR p;
+
+	switch (op) {
+	case OP_ALLOC:
+		if (0 == count[S_FREE]) return FALSE;
+		TIMED(p = allocPcb());
+		if (p == NULL)
+			adderrbuf("alloc: allocPcb failed with PCBs left   ");
+		i = indexOf(p);
+		if (i >= MAXPROC || state[i] != S_FREE)
+			adderrbuf("alloc: allocPcb returned a PCB in use   ");
+		slot[i] = p;
+		setState(i, S_IDLE);
+		break;
+
+	case OP_FREE:
+		/* PCBs in a tree are only freed by a teardown */
+		if ((i = pickSlot(arg, S_IDLE)) < 0) return FALSE;
+		if (!emptyChild(slot[i]) || slot[i]->p_parent != NILLINK) return FALSE;
+		TIMED(freePcb(slot[i]));
+		setState(i, S_FREE);
+		break;
+
+	case OP_READY:
+		if ((i = pickSlot(arg, S_IDLE)) < 0) return FALSE;
+		TIMED(insertReadyQ(&rq, slot[i]));
+		setState(i, S_READY);
+		break;
+
+	case OP_RUN:
+		if (0 == count[S_READY]) return FALSE;
+		TIMED(p = removeReadyQ(&rq));
+		if ((i = slotOf(p)) < 0 || state[i] != S_READY)
+			adderrbuf("run: removeReadyQ returned a PCB that was not ready   ");
+		setState(i, S_IDLE);
+		break;
+
+	case OP_PRIO:
+		/* a ready PCB changes level, a blocked one may move in its queue */
+		if ((i = pickSlot(arg, (arg >> 31) ? S_BLOCKED : S_READY)) < 0) return FALSE;
+		TIMED(setPriority(&rq, slot[i], (arg >> 8) % PRIOLEVELS));
+		break;
+
+	case OP_P:
+		if ((i = pickSlot(arg, S_IDLE)) < 0) return FALSE;
+		j = pickSem(arg);
+		byPrio = (arg >> 31);
+		if (byPrio)
+			TIMED(byPrio = insertBlockedPrio(&sem[j], slot[i]) ? -1 : TRUE);
+		else
+			TIMED(byPrio = insertBlocked(&sem[j], slot[i]) ? -1 : FALSE);
+		if (byPrio < 0) break;
+		/* the first waiter decides the order of the queue */
+		if (0 == semWaiters[j]++)
+			semByPrio[j] = byPrio;
+		setState(i, S_BLOCKED);
+		break;
+
+	case OP_V:
+		j = pickSem(arg);
+		TIMED(p = removeBlocked(&sem[j]));
+		if (p == NULL) break;
+		if ((i = slotOf(p)) < 0 || state[i] != S_BLOCKED)
+			adderrbuf("V: removeBlocked returned a PCB that was not blocked   ");
+		if (semByPrio[j])
+			checkPrioOrder(j, p);
+		semWaiters[j]--;
+		setState(i, S_IDLE);
+		break;
+
+	case OP_OUT:
+		if ((i = pickSlot(arg, S_BLOCKED)) < 0) return FALSE;
+		semWaiters[slot[i]->p_semAdd - sem]--;
+		TIMED(p = outBlocked(slot[i]));
+		if (p != slot[i])
+			adderrbuf("out: outBlocked failed on a blocked PCB   ");
+		setState(i, S_IDLE);
+		break;
+
+	case OP_CHILD:
+		/* an orphan becomes the child of any other PCB but its descendants */
+		if (MAXPROC - count[S_FREE] < 2) return FALSE;
+		if ((i = pickSlot(arg, S_IDLE)) < 0 || slot[i]->p_parent != NILLINK) return FALSE;
+		for (j = (arg >> 8) % MAXPROC; state[j] == S_FREE || j == i; j = (j + 1) % MAXPROC);
+		for (p = slot[j]; p != NULL && p != slot[i]; p = GETPCB(p, p_parent));
+		if (p != NULL) return FALSE;
+		TIMED(insertChild(slot[j], slot[i]));
+		break;
+
+	case OP_KILL:
+		if ((i = pickSlot(arg, S_IDLE)) < 0) return FALSE;
+		TIMED(outSubtree(slot[i], killPcb, NULL));
+		break;
+
+	case OP_ADOPT:
+		/* the children of a PCB move to its parent, if it has one */
+		if ((i = pickSlot(arg, S_IDLE)) < 0 || slot[i]->p_parent == NILLINK) return FALSE;
+		TIMED(adoptChildren(GETPCB(slot[i], p_parent), slot[i]));
+		break;
+	}
+
+	return TRUE;
+}
+
+
+/* This function checks the PCB fields against the slot states */
+void checkInvariants(void) {
+	int i, level, n;
+	pcb_PTR p;
+
+	n = 0;
+	for (i = 0; i < MAXPROC; i++) {
+		if (state[i] == S_FREE) continue;
+		p = slot[i];
+		n++;
+
+		switch (state[i]) {
+		case S_IDLE:
+			if (p->p_queue != NULL || p->p_semd != NILLINK)
+				adderrbuf("check: idle PCB in a queue   ");
+			break;
+		case S_READY:
+			if (p->p_queue != &(rq.rq_tail[p->p_prio]) || p->p_semd != NILLINK)
+				adderrbuf("check: ready PCB not in its ready level   ");
+			break;
+		case S_BLOCKED:
+			if (p->p_semd == NILLINK || GETSEMD(p, p_semd)->s_semAdd != p->p_semAdd
+				|| p->p_queue != &(GETSEMD(p, p_semd)->s_procQ) || headBlocked(p->p_semAdd) == NULL)
+				adderrbuf("check: blocked PCB not on its semaphore   ");
+			break;
+		}
+
+		if (p->p_parent != NILLINK && slotOf(GETPCB(p, p_parent)) < 0)
+			adderrbuf("check: parent of a PCB not allocated   ");
+		if (p->p_parent != NILLINK)
+			children[slotOf(GETPCB(p, p_parent))]++;
+	}
+	if (n != MAXPROC - count[S_FREE])
+		adderrbuf("check: slot counts out of sync   ");
+
+	/* every child count matches the PCBs naming that parent */
+	for (i = 0; i < MAXPROC; i++) {
+		if (state[i] != S_FREE && childCount(slot[i]) != children[i])
+			adderrbuf("check: child count out of sync   ");
+		children[i] = 0;
+	}
+
+	/* the ready levels hold exactly the ready PCBs */
+	n = 0;
+	for (level = 0; level < PRIOLEVELS; level++) {
+		if (emptyProcQ(rq.rq_tail[level])) continue;
+		p = rq.rq_tail[level];
+		do {
+			p = GETPCB(p, p_next);
+			n++;
+		} while (p != rq.rq_tail[level]);
+	}
+	if (n != count[S_READY])
+		adderrbuf("check: ready queue length out of sync   ");
+}
+
+
+/* This function prints one "soak,op,count,ticks,maxticks" line on terminal0 */
+void report(char *op, unsigned int cnt, cpu_t ticks, cpu_t maxTicks) {
+	char line[80];
+	char *lp = line;
+
+	lp = fmtstr(lp, "soak,");
+	lp = fmtstr(lp, op);
+	*lp++ = ',';
+	lp = fmtuint(lp, cnt);
+	*lp++ = ',';
+	lp = fmtuint(lp, ticks);
+	*lp++ = ',';
+	lp = fmtuint(lp, maxTicks);
+	*lp++ = '\n';
+	*lp = EOS;
+
+	termprint(line, 0);
+}
+
+
+/* This function prints one line of the histogram dump on terminal0 */
+void printLine(char *line) {
+	termprint(line, 0);
+}
+
+
+#ifdef SOAK_RECORD
+/* This function prints one "trace,{op, arg}," line on terminal0 */
+void recordOp(int op, unsigned int arg) {
+	char line[40];
+	char *lp = line;
+
+	lp = fmtstr(lp, "trace,{");
+	lp = fmtuint(lp, op);
+	lp = fmtstr(lp, ", ");
+	lp = fmtuint(lp, arg);
+	lp = fmtstr(lp, "},\n");
+	*lp = EOS;
+
+	termprint(line, 0);
+}
+#endif
+
+
+void main() {
+	int i, op;
+	unsigned int n, total, arg, checks;
+	cpu_t start, end, checkTicks, checkMax;
+#ifdef PHASE1_ACCT
+	char level[16];
+#endif
+
+	initTermOut();
+	initPcbs();
+	initASL();
+	initReadyQ(&rq);
+	for (i = 0; i < MAXPROC; i++)
+		state[i] = S_FREE;
+	count[S_FREE] = MAXPROC;
+
+#ifdef SOAK_REPLAY
+	total = TRACELEN;
+#else
+	total = SOAKOPS;
+#endif
+
+	termprint("# soak,op,count,ticks,maxticks\n", 0);
+
+	checks = 0;
+	checkTicks = checkMax = 0;
+	STCK(start);
+	for (n = 0; n < total; n++) {
+#ifdef SOAK_REPLAY
+		op = soakTrace[n].t_op;
+		arg = soakTrace[n].t_arg;
+		if (op < 0 || op >= NOPS)
+			adderrbuf("replay: bad operation in trace   ");
+#else
+		op = pickOp(nextRand() >> 8);
+		arg = nextRand();
+#endif
+#ifdef SOAK_RECORD
+		recordOp(op, arg);
+#endif
+
+		if (runOp(op, arg)) {
+			opCount[op]++;
+			opTicks[op] += t1 - t0;
+			opMax[op] = MAX(opMax[op], t1 - t0);
+		}
+
+		if (0 == (n + 1) % CHECKEVERY || n + 1 == total) {
+			TIMED(checkInvariants());
+			checks++;
+			checkTicks += t1 - t0;
+			checkMax = MAX(checkMax, t1 - t0);
+		}
+	}
+	STCK(end);
+
+	for (op = 0; op < NOPS; op++)
+		report(opNames[op], opCount[op], opTicks[op], opMax[op]);
+	report("check", checks, checkTicks, checkMax);
+	report("total", total, end - start - checkTicks, 0);
+
+#ifdef PHASE1_ACCT
+	/* ready queue waits, one histogram per level */
+	for (op = 0; op < PRIOLEVELS; op++) {
+		*fmtuint(fmtstr(level, "ready"), op) = EOS;
+		dumpHist(level, &(rq.rq_hist[op]), printLine);
+	}
+#endif
+
+	termprint("# done\n", 0);
+	termFlush(0);
+}
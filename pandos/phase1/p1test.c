@@ -15,12 +15,20 @@
 #include "../h/const.h"
 #include "../h/types.h"
 
-#include "/usr/include/umps3/umps/libumps.h"
+#include "../h/port.h"
 #include "../h/pcb.h"
 #include "../h/asl.h"
+#include "../h/readyq.h"
+#include "../h/sleepq.h"
+#include "../h/trace.h"
+#include "../h/termout.h"
+#include "../h/timer.h"
 
 
-#define MAXPROC	20
+/* MAXPROC and MAXSEMD come from the build configuration (see Makefile) */
+#if MAXPROC < 20
+#error "p1test needs MAXPROC >= 20"
+#endif
 #define	MAXSEM	MAXPROC
 
 char okbuf[2048];			/* sequence of progress messages */
@@ -28,71 +36,40 @@ char errbuf[128];			/* contains reason for failing */
 char msgbuf[128];			/* nonrecoverable error message before shut down */
 int sem[MAXSEM];
 int onesem;
-pcb_t	*procp[MAXPROC], *p, *qa, *q, *firstproc, *lastproc, *midproc;
+int devsem[DEVSEMNUM];
+pcb_t	*procp[MAXPROC], *p, *qa, *qb, *q, *firstproc, *lastproc, *midproc;
+readyq_t rq, cpuq[2];
+procid_t pid;
+sleepq_t sq;
+timers_t tm;
 char *mp = okbuf;
 
 
-#define TRANSMITTED	5
-#define ACK	1
-#define PRINTCHR	2
-#define CHAROFFSET	8
-#define STATUSMASK	0xFF
-#define	TERM0ADDR	0x10000254
+/* This function queues a string for output on the specified terminal and 
+ * returns TRUE if it was accepted, FALSE if not (see h/termout.h) */
+unsigned int termprint(char * str, unsigned int term) {
+	return termWrite(term, str);
+}
 
-typedef unsigned int devreg;
 
-/* This function returns the terminal transmitter status value given its address */ 
-devreg termstat(memaddr * stataddr) {
-	return((*stataddr) & STATUSMASK);
+#ifdef PHASE1_TRACE
+int traceLines;
+
+/* This function writes a trace line out to terminal0 */
+void printTrace(char *line) {
+	termprint(line, 0);
 }
 
-/* This function prints a string on specified terminal and returns TRUE if 
- * print was successful, FALSE if not   */
-unsigned int termprint(char * str, unsigned int term) {
-	memaddr * statusp;
-	memaddr * commandp;
-	devreg stat;
-	devreg cmd;
-	unsigned int error = FALSE;
-	
-	if (term < DEVPERINT) {
-		/* terminal is correct */
-		/* compute device register field addresses */
-		statusp = (devreg *) (TERM0ADDR + (term * DEVREGSIZE) + (TRANSTATUS * DEVREGLEN));
-		commandp = (devreg *) (TERM0ADDR + (term * DEVREGSIZE) + (TRANCOMMAND * DEVREGLEN));
-		
-		/* test device status */
-		stat = termstat(statusp);
-		if (stat == READY || stat == TRANSMITTED) {
-			/* device is available */
-			
-			/* print cycle */
-			while (*str != EOS && !error) {
-				cmd = (*str << CHAROFFSET) | PRINTCHR;
-				*commandp = cmd;
-
-				/* busy waiting */
-				stat = termstat(statusp);
-				while (stat == BUSY)
-					 stat = termstat(statusp);
-				
-				/* end of wait */
-				if (stat != TRANSMITTED)
-					error = TRUE;
-				else
-					/* move to next char */
-					str++;
-			} 
-		}
-		else
-			/* device is not available */
-			error = TRUE;
-	}
-	else
-		/* wrong terminal device number */
-		error = TRUE;
+/* This function counts the lines of a trace dump */
+void countTrace(char *line) {
+	traceLines++;
+}
+#endif
+
 
-	return (!error);		
+/* This function counts the PCBs visited by a process tree walk */
+void countPcb(pcb_PTR p, void *arg) {
+	(*((int *) arg))++;
 }
 
 
@@ -117,6 +94,12 @@ void adderrbuf(char *strp) {
 	while ((*ep++ = *strp++) != '\0');
 	
 	termprint(tstrp, 0);
+#ifdef PHASE1_TRACE
+	/* the events leading to the failure */
+	termprint("\n", 0);
+	dumpTrace(printTrace);
+#endif
+	termFlush(0);
 		
 	PANIC();
 }
@@ -125,7 +108,11 @@ void adderrbuf(char *strp) {
 
 void main() {
 	int i;
+#ifdef PHASE1_TRACE
+	unsigned int j, k;
+#endif
 
+	initTermOut();
 	initPcbs();
 	addokbuf("Initialized process control blocks   \n");
 
@@ -144,6 +131,43 @@ void main() {
 		freePcb(procp[i]);
 	addokbuf("freed 10 entries   \n");
 
+	/* the live list holds the 10 PCBs still allocated, and no freed one */
+	for (i = 0, q = firstLive(); q != NULL; q = nextLive(q), i++)
+		if (0 == (q->p_gen & 1))
+			adderrbuf("nextLive: free PCB on the live list   ");
+	if (i != 10 || liveCount() != 10)
+		adderrbuf("liveCount: wrong number of live PCBs   ");
+	i = 0;
+	walkLive(countPcb, &i);
+	if (i != 10 || firstLive() != procp[9])
+		adderrbuf("walkLive: live PCBs not visited newest first   ");
+	addokbuf("live PCB list ok   \n");
+
+#ifdef PHASE1_TRACE
+	/* every allocation and free so far was traced, and is dumped once */
+	i = traceCount;
+	if (i != 2 * MAXPROC - 10 || TR_FREE != traceRing[(i - 1) & (TRACESIZE - 1)].te_op
+		|| NOLINK == traceRing[(i - 1) & (TRACESIZE - 1)].te_pcb)
+		adderrbuf("traceEvent: allocations and frees not recorded   ");
+	traceLines = 0;
+	dumpTrace(countTrace);
+	if (traceLines != ((i > TRACESIZE) ? TRACESIZE + 1 : i))
+		adderrbuf("dumpTrace: wrong number of events dumped   ");
+	traceLines = 0;
+	dumpTrace(countTrace);
+	if (traceLines != 0)
+		adderrbuf("dumpTrace: events dumped twice   ");
+	addokbuf("event trace ok   \n");
+#endif
+
+	/* take the 10 free entries back in one batch, then return them */
+	if (allocPcbBatch(&procp[10], MAXPROC - 10) != MAXPROC - 10)
+		adderrbuf("allocPcbBatch: allocated too few entries   ");
+	if (allocPcbBatch(&procp[10], 1) != 0 || allocPcb() != NULL)
+		adderrbuf("allocPcbBatch: allocated more than MAXPROC entries   ");
+	freePcbBatch(&procp[10], MAXPROC - 10);
+	addokbuf("allocPcbBatch and freePcbBatch ok   \n");
+
 	/* create a 10-element process queue */
 	qa = NULL;
 	if (!emptyProcQ(qa)) adderrbuf("emptyProcQ: unexpected FALSE   ");
@@ -201,6 +225,70 @@ void main() {
                 adderrbuf("emptyProcQ: unexpected FALSE   ");
 
 	addokbuf("insertProcQ, removeProcQ and emptyProcQ ok   \n");
+
+	/* check process handles across a free and a reallocation */
+	q = allocPcb();
+	pid = pcbToHandle(q);
+	if (pid == NOPROCID || handleToPcb(pid) != q || handleToPcb(NOPROCID) != NULL)
+		adderrbuf("pcbToHandle: handle does not name its PCB   ");
+	freePcb(q);
+	if (pcbToHandle(q) != NOPROCID || handleToPcb(pid) != NULL)
+		adderrbuf("handleToPcb: handle of a freed PCB not stale   ");
+	if (allocPcb() != q || handleToPcb(pid) != NULL || handleToPcb(pcbToHandle(q)) != q)
+		adderrbuf("handleToPcb: handle of a reused PCB not stale   ");
+	freePcb(q);
+#ifndef PHASE1_DEBUG
+	/* outside debug builds a second free is ignored, not pushed again */
+	freePcb(q);
+	procp[10] = allocPcb();
+	procp[11] = allocPcb();
+	if (procp[10] == procp[11])
+		adderrbuf("freePcb: free PCB freed again   ");
+	freePcb(procp[10]);
+	freePcb(procp[11]);
+#endif
+	addokbuf("pcbToHandle and handleToPcb ok   \n");
+
+#if defined(PHASE1_SMP) && defined(PHASE1_HOST)
+	/* the free PCBs cached by the other processors are reclaimed before 
+	 * allocPcb or allocPcbBatch report that none is left (only the host 
+	 * build can stand in for another processor, through hostCpu) */
+	for (hostCpu = 1; hostCpu < NCPU; hostCpu++) {
+		for (i = 10; i < MAXPROC; i++)
+			if ((procp[i] = allocPcb()) == NULL)
+				adderrbuf("allocPcb: cached PCBs not reclaimed   ");
+		for (i = 10; i < MAXPROC; i++)
+			freePcb(procp[i]);
+	}
+	hostCpu = 0;
+	for (i = 10; i < MAXPROC; i++)
+		if ((procp[i] = allocPcb()) == NULL)
+			adderrbuf("allocPcb: cached PCBs not reclaimed   ");
+	if (allocPcb() != NULL)
+		adderrbuf("allocPcb: allocated more than MAXPROC entries   ");
+	for (hostCpu = 1; hostCpu < NCPU; hostCpu++)
+		freePcb(procp[9 + hostCpu]);
+	hostCpu = 0;
+	if (allocPcbBatch(&procp[10], NCPU - 1) != NCPU - 1)
+		adderrbuf("allocPcbBatch: cached PCBs not reclaimed   ");
+	for (i = 10; i < MAXPROC; i++)
+		freePcb(procp[i]);
+	addokbuf("per-CPU PCB caches ok   \n");
+#endif
+
+#if defined(PCB_BITMAPALLOC) && !defined(PHASE1_SMP)
+	/* the bitmap allocator reuses the lowest free PCB, not the last freed 
+	 * (with PHASE1_SMP the per-CPU caches hand out recently freed ones) */
+	procp[10] = allocPcb();
+	procp[11] = allocPcb();
+	q = (procp[10] < procp[11]) ? procp[10] : procp[11];
+	freePcb(q);
+	freePcb((q == procp[10]) ? procp[11] : procp[10]);
+	if (allocPcb() != q)
+		adderrbuf("allocPcb: bitmap allocator skipped the lowest free PCB   ");
+	freePcb(q);
+	addokbuf("bitmap PCB allocator ok   \n");
+#endif
 	addokbuf("process queues module ok      \n");\
 
 	addokbuf("checking process trees...\n");
@@ -242,8 +330,145 @@ void main() {
 	    adderrbuf("emptyChild: unexpected FALSE   ");
 	    
 	addokbuf("insertChild, removep1test-partialChild and emptyChild ok   \n");
+
+	/* Check the subtree walks on 0 -> {1, 2}, 1 -> {3, 4}, 3 -> {5} */
+	insertChild(procp[0], procp[1]);
+	insertChild(procp[0], procp[2]);
+	insertChild(procp[1], procp[3]);
+	insertChild(procp[1], procp[4]);
+	insertChild(procp[3], procp[5]);
+	i = 0;
+	walkSubtree(procp[0], countPcb, &i);
+	if (i != 6)
+		adderrbuf("walkSubtree: wrong number of visits   ");
+	i = 0;
+	outSubtree(procp[1], countPcb, &i);
+	if (i != 4)
+		adderrbuf("outSubtree: wrong number of visits   ");
+	if (GETPCB(procp[0], p_child) != procp[2] || procp[2]->p_sib_next != NILLINK || !emptyChild(procp[1])
+		|| !emptyChild(procp[3]) || procp[5]->p_parent != NILLINK)
+		adderrbuf("outSubtree: subtree not detached   ");
+	if (outChild(procp[2]) != procp[2] || !emptyChild(procp[0]))
+		adderrbuf("outSubtree: wrong siblings left   ");
+	addokbuf("walkSubtree and outSubtree ok   \n");
+
+	/* Check adoptChildren on 0 -> {2, 1} and 3 -> {5, 4} */
+	insertChild(procp[0], procp[1]);
+	insertChild(procp[0], procp[2]);
+	insertChild(procp[3], procp[4]);
+	insertChild(procp[3], procp[5]);
+	adoptChildren(procp[0], procp[3]);
+	if (childCount(procp[0]) != 4 || childCount(procp[3]) != 0 || !emptyChild(procp[3]))
+		adderrbuf("adoptChildren: wrong child counts   ");
+	if (GETPCB(procp[1], p_sib_next) != procp[5] || GETPCB(procp[5], p_sib_prev) != procp[1]
+		|| GETPCB(procp[4], p_parent) != procp[0] || GETPCB(procp[0], p_lastChild) != procp[4])
+		adderrbuf("adoptChildren: children not appended   ");
+	if (outChild(procp[4]) != procp[4] || GETPCB(procp[0], p_lastChild) != procp[5])
+		adderrbuf("outChild: last child not updated   ");
+	for (i = 0; i < 3; i++)
+		removeChild(procp[0]);
+	if (childCount(procp[0]) != 0 || !emptyChild(procp[0]))
+		adderrbuf("removeChild: child count not updated   ");
+	addokbuf("adoptChildren and childCount ok   \n");
 	addokbuf("process tree module ok      \n");
 
+	addokbuf("checking ready queue...\n");
+	initReadyQ(&rq);
+	if (!emptyReadyQ(&rq))
+		adderrbuf("emptyReadyQ: unexpected FALSE   ");
+	procp[0]->p_prio = LOWPRIO;
+	procp[1]->p_prio = DEFAULTPRIO;
+	procp[2]->p_prio = DEFAULTPRIO;
+	for (i = 0; i < 3; i++)
+		insertReadyQ(&rq, procp[i]);
+	if (headReadyQ(&rq) != procp[1])
+		adderrbuf("headReadyQ: wrong process returned   ");
+	setPriority(&rq, procp[0], HIGHPRIO);
+	if (removeReadyQ(&rq) != procp[0])
+		adderrbuf("setPriority: process not moved to its new level   ");
+	if (outReadyQ(&rq, procp[0]) != NULL)
+		adderrbuf("outReadyQ: removed a process not in the queue   ");
+	if (outReadyQ(&rq, procp[2]) != procp[2])
+		adderrbuf("outReadyQ: failed on queued process   ");
+	if (removeReadyQ(&rq) != procp[1] || removeReadyQ(&rq) != NULL)
+		adderrbuf("removeReadyQ: wrong removal order   ");
+	if (!emptyReadyQ(&rq))
+		adderrbuf("emptyReadyQ: unexpected FALSE   ");
+#ifdef PHASE1_ACCT
+	if (rq.rq_hist[LOWPRIO].wh_count != 1 || rq.rq_hist[HIGHPRIO].wh_count != 1
+		|| rq.rq_hist[DEFAULTPRIO].wh_count != 2)
+		adderrbuf("ready queue: waits not recorded per level   ");
+#endif
+	initReadyQ(&cpuq[0]);
+	initReadyQ(&cpuq[1]);
+	if (stealReadyQ(cpuq, 2, 0) != NULL)
+		adderrbuf("stealReadyQ: stole from an empty queue   ");
+	for (i = 0; i < 3; i++)
+		insertReadyQ(&cpuq[1], procp[i]);
+	if (stealReadyQ(cpuq, 2, 1) != NULL)
+		adderrbuf("stealReadyQ: stole from its own queue   ");
+	if (stealReadyQ(cpuq, 2, 0) != procp[0] || stealReadyQ(cpuq, 2, 0) != procp[2])
+		adderrbuf("stealReadyQ: did not take the tail of the highest level   ");
+	if (removeReadyQ(&cpuq[1]) != procp[1] || stealReadyQ(cpuq, 2, 0) != NULL)
+		adderrbuf("stealReadyQ: victim queue corrupted   ");
+	insertReadyQ(&cpuq[1], procp[2]);
+	setPriority(&cpuq[0], procp[2], HIGHPRIO);
+	insertReadyQ(&cpuq[1], procp[1]);
+	if (procp[2]->p_prio != HIGHPRIO || outReadyQ(&cpuq[1], procp[2]) != procp[2]
+		|| removeReadyQ(&cpuq[1]) != procp[1] || !emptyReadyQ(&cpuq[1]))
+		adderrbuf("setPriority: stranded a process queued elsewhere   ");
+	procp[2]->p_prio = DEFAULTPRIO;
+#ifdef PHASE1_SMP
+	for (i = 0; i < NCPU; i++)
+		initReadyQ(&cpuReadyQ[i]);
+	insertReadyQ(&cpuReadyQ[NCPU - 1], procp[1]);
+	if (nextReady() != procp[1] || nextReady() != NULL)
+		adderrbuf("nextReady: did not steal from another processor   ");
+#endif
+	addokbuf("ready queue module ok      \n");
+
+	addokbuf("checking sleep queue...\n");
+	initSleepQ(&sq);
+	qa = mkEmptyProcQ();
+	if (!emptySleepQ(&sq) || wakeSleepQ(&sq, &qa) != 0)
+		adderrbuf("initSleepQ: sleep queue not empty   ");
+#ifdef PHASE1_TRACE
+	j = traceCount;
+#endif
+	insertSleepQ(&sq, procp[0], 100000000);
+	insertSleepQ(&sq, procp[1], 0);
+	insertSleepQ(&sq, procp[2], 50000000);
+	insertSleepQ(&sq, procp[3], 0);
+	if (headProcQ(sq.sq_tail) != procp[1] || GETPCB(procp[1], p_next) != procp[3]
+		|| GETPCB(procp[3], p_next) != procp[2] || sq.sq_tail != procp[0])
+		adderrbuf("insertSleepQ: sleepers not in wakeup order   ");
+	if (outSleepQ(&sq, procp[2]) != procp[2] || outSleepQ(&sq, procp[2]) != NULL)
+		adderrbuf("outSleepQ: wrong removal   ");
+	if (wakeSleepQ(&sq, &qa) != 2 || removeProcQ(&qa) != procp[1] || removeProcQ(&qa) != procp[3] || !emptyProcQ(qa))
+		adderrbuf("wakeSleepQ: wrong processes woken   ");
+	if (headProcQ(sq.sq_tail) != procp[0] || nextWakeup(&sq) <= 50000000)
+		adderrbuf("wakeSleepQ: wakeup time of a sleeper changed   ");
+	if (outSleepQ(&sq, procp[0]) != procp[0] || !emptySleepQ(&sq) || nextWakeup(&sq) != MAX_INT)
+		adderrbuf("outSleepQ: sleep queue not empty   ");
+	/* a later sleeper goes after the only one, which keeps its wakeup time */
+	insertSleepQ(&sq, procp[0], 0);
+	insertSleepQ(&sq, procp[1], 100000000);
+	if (headProcQ(sq.sq_tail) != procp[0] || sq.sq_tail != procp[1] || procp[1]->p_delta <= 0)
+		adderrbuf("insertSleepQ: later sleeper not appended   ");
+	if (wakeSleepQ(&sq, &qa) != 1 || removeProcQ(&qa) != procp[0] || outSleepQ(&sq, procp[1]) != procp[1])
+		adderrbuf("wakeSleepQ: earlier sleeper not woken   ");
+#ifdef PHASE1_TRACE
+	/* each sleeper was traced in and out of the queue */
+	for (i = k = 0; j != traceCount; j++)
+		if ((void *) &(sq.sq_tail) == traceRing[j & (TRACESIZE - 1)].te_addr) {
+			i += (TR_ENQUEUE == traceRing[j & (TRACESIZE - 1)].te_op);
+			k += (TR_DEQUEUE == traceRing[j & (TRACESIZE - 1)].te_op);
+		}
+	if (i != 6 || k != 6)
+		adderrbuf("insertSleepQ: enqueues and dequeues not traced alike   ");
+#endif
+	addokbuf("sleep queue module ok      \n");
+
 	for (i = 0; i < 10; i++) 
 		freePcb(procp[i]);
 
@@ -271,8 +496,11 @@ void main() {
 	if (insertBlocked(&sem[11],p))
 		adderrbuf("removeBlocked: fails to return to free list   ");
 
+#if MAXSEMD == MAXPROC
+	/* every descriptor is in use now, so one more semaphore must fail */
 	if (insertBlocked(&onesem, procp[9]) == FALSE)
 		adderrbuf("insertBlocked: inserted more than MAXPROC   ");
+#endif
 	
 	addokbuf("removeBlocked test started   \n");
 	for (i = 10; i< MAXPROC; i++) {
@@ -284,11 +512,11 @@ void main() {
 		if (insertBlocked(&sem[i-10], q))
 			adderrbuf("insertBlocked(3): unexpected TRUE   ");
 	}
-	if (removeBlocked(&sem[11]) != NULL)
+	if (removeBlocked(&sem[MAXSEM - 1]) != NULL)
 		adderrbuf("removeBlocked: removed nonexistent blocked proc   ");
 	addokbuf("insertBlocked and removeBlocked ok   \n");
 
-	if (headBlocked(&sem[11]) != NULL)
+	if (headBlocked(&sem[MAXSEM - 1]) != NULL)
 		adderrbuf("headBlocked: nonNULL for a nonexistent queue   ");
 	if ((q = headBlocked(&sem[9])) == NULL)
 		adderrbuf("headBlocked(1): NULL for an existent queue   ");
@@ -311,9 +539,145 @@ void main() {
 	if (headBlocked(&sem[9]) != NULL)
 		adderrbuf("out/headBlocked: unexpected nonempty queue   ");
 	addokbuf("headBlocked and outBlocked ok   \n");
+
+	/* check removeAllBlocked on a semaphore with two waiters */
+	if (insertBlocked(&sem[9], procp[9]) || insertBlocked(&sem[9], procp[19]))
+		adderrbuf("insertBlocked(4): unexpected TRUE   ");
+	qa = removeAllBlocked(&sem[9]);
+	unblockProcQ(&qa);
+	if (headBlocked(&sem[9]) != NULL)
+		adderrbuf("removeAllBlocked: semaphore still active   ");
+	if (procp[9]->p_semAdd != NULL || procp[19]->p_semAdd != NULL)
+		adderrbuf("unblockProcQ: p_semAdd not cleared   ");
+	if (removeProcQ(&qa) != procp[9] || removeProcQ(&qa) != procp[19] || !emptyProcQ(qa))
+		adderrbuf("removeAllBlocked: wrong queue returned   ");
+	if (!emptyProcQ(removeAllBlocked(&sem[9])))
+		adderrbuf("removeAllBlocked: nonempty queue for an inactive semaphore   ");
+	addokbuf("removeAllBlocked ok   \n");
+
+#ifdef ASL_HYSTERESIS
+	/* an emptied descriptor is kept and reused by the next P */
+	if (insertBlocked(&sem[9], procp[9]) || removeBlocked(&sem[9]) != procp[9])
+		adderrbuf("insertBlocked(6): semaphore not usable   ");
+	i = semdCache.sc_hits;
+	if (headBlocked(&sem[9]) != NULL || removeBlocked(&sem[9]) != NULL)
+		adderrbuf("headBlocked: inactive descriptor visible   ");
+	if (insertBlocked(&sem[9], procp[9]) || semdCache.sc_hits != i + 1 || removeBlocked(&sem[9]) != procp[9])
+		adderrbuf("insertBlocked(6): inactive descriptor not reused   ");
+	addokbuf("descriptor cache ok   \n");
+#endif
+
+	/* check the device semaphores, which bypass the ASL (procp[18] 
+	 * is still blocked on sem[8] and must leave it first) */
+	registerDevSems(devsem);
+	if (outBlocked(procp[18]) != procp[18])
+		adderrbuf("outBlocked(3): couldn't remove from valid queue   ");
+	if (insertBlocked(&devsem[0], procp[9]) || insertBlocked(&devsem[0], procp[19])
+		|| insertBlocked(&devsem[CLOCKSEM], procp[18]))
+		adderrbuf("insertBlocked(5): unexpected TRUE   ");
+	if (headBlocked(&devsem[0]) != procp[9] || headBlocked(&devsem[CLOCKSEM]) != procp[18])
+		adderrbuf("headBlocked(3): wrong pcb returned   ");
+	if (outBlocked(procp[18]) != procp[18] || headBlocked(&devsem[CLOCKSEM]) != NULL)
+		adderrbuf("outBlocked(3): device semaphore not emptied   ");
+	if (removeBlocked(&devsem[0]) != procp[9] || removeBlocked(&devsem[0]) != procp[19])
+		adderrbuf("removeBlocked(3): wrong pcb removed   ");
+	if (removeBlocked(&devsem[0]) != NULL || headBlocked(&devsem[0]) != NULL)
+		adderrbuf("removeBlocked(3): device semaphore not emptied   ");
+#ifdef PHASE1_ACCT
+	if (semWaitHist(&devsem[0])->wh_count != 2 || semWaitHist(&devsem[CLOCKSEM])->wh_count != 1)
+		adderrbuf("semWaitHist: waits not recorded   ");
+#endif
+	registerDevSems(NULL);
+	addokbuf("device semaphores ok   \n");
+
+	/* check the priority ordered queues: by p_prio, FIFO among equals */
+	if (outBlocked(procp[0]) != procp[0] || outBlocked(procp[1]) != procp[1])
+		adderrbuf("outBlocked(4): couldn't remove from valid queue   ");
+	procp[0]->p_prio = LOWPRIO;
+	procp[1]->p_prio = procp[18]->p_prio = procp[19]->p_prio = DEFAULTPRIO;
+	procp[9]->p_prio = HIGHPRIO;
+	if (insertBlockedPrio(&sem[9], procp[18]) || insertBlockedPrio(&sem[9], procp[0])
+		|| insertBlockedPrio(&sem[9], procp[9]) || insertBlockedPrio(&sem[9], procp[1])
+		|| insertBlockedPrio(&sem[9], procp[19]))
+		adderrbuf("insertBlockedPrio: unexpected TRUE   ");
+	if (headBlocked(&sem[9]) != procp[9] || outBlocked(procp[1]) != procp[1])
+		adderrbuf("insertBlockedPrio: wrong head or waiter   ");
+#ifdef PHASE1_TRACE
+	j = traceCount;
+#endif
+	setPriority(&rq, procp[0], HIGHPRIO);
+#ifdef PHASE1_TRACE
+	/* the waiter was moved within its queue, not out and back in */
+	if (traceCount != j)
+		adderrbuf("setBlockedPrio: waiter traced out of its queue   ");
+#endif
+	if (removeBlocked(&sem[9]) != procp[9] || headBlocked(&sem[9]) != procp[0])
+		adderrbuf("setPriority: waiter not moved in its queue   ");
+	setBlockedPrio(procp[0], LOWPRIO + 1);
+	if (procp[0]->p_prio != LOWPRIO)
+		adderrbuf("setBlockedPrio: priority not clamped   ");
+	if (removeBlocked(&sem[9]) != procp[18]
+		|| removeBlocked(&sem[9]) != procp[19] || removeBlocked(&sem[9]) != procp[0]
+		|| headBlocked(&sem[9]) != NULL)
+		adderrbuf("removeBlocked(4): not in priority order   ");
+	if (insertBlocked(&sem[9], procp[0]) || insertBlockedPrio(&sem[9], procp[9])
+		|| removeBlocked(&sem[9]) != procp[0] || removeBlocked(&sem[9]) != procp[9])
+		adderrbuf("insertBlockedPrio: FIFO queue reordered   ");
+	if (insertBlockedPrio(&sem[9], procp[18]) || insertBlockedPrio(&sem[9], procp[0])
+		|| insertBlockedPrio(&sem[9], procp[9]) || insertBlockedPrio(&sem[9], procp[1])
+		|| insertBlockedPrio(&sem[9], procp[19]))
+		adderrbuf("insertBlockedPrio: unexpected TRUE   ");
+	qa = removeAllBlocked(&sem[9]);
+	unblockProcQ(&qa);
+	if (removeProcQ(&qa) != procp[9] || removeProcQ(&qa) != procp[18] || removeProcQ(&qa) != procp[1]
+		|| removeProcQ(&qa) != procp[19] || removeProcQ(&qa) != procp[0] || !emptyProcQ(qa))
+		adderrbuf("removeAllBlocked: not in priority order   ");
+#ifdef PHASE1_ACCT
+	/* sem[9]'s descriptor was freed: its next one adds to the same histogram */
+	i = semWaitHist(&sem[9])->wh_count;
+	if (insertBlocked(&sem[9], procp[0]) || removeBlocked(&sem[9]) != procp[0]
+		|| semWaitHist(&sem[9])->wh_count != i + 1)
+		adderrbuf("semWaitHist: waits lost with the descriptor   ");
+#endif
+	addokbuf("priority ordered queues ok   \n");
 	addokbuf("ASL module ok   \n");
 
+	addokbuf("checking timer events...\n");
+	initSleepQ(&sq);
+	initTimers(&tm, &sq, &onesem);
+	if (nextDeadline(&tm) != MAX_INT || dueTimers(&tm) != 0)
+		adderrbuf("initTimers: deadline without any event   ");
+	startQuantum(&tm, TIMESLICE);
+	if (nextDeadline(&tm) <= 0 || nextDeadline(&tm) > TIMESLICE)
+		adderrbuf("startQuantum: quantum end not the deadline   ");
+	insertSleepQ(&sq, procp[18], TIMESLICE / 2);
+	if (nextDeadline(&tm) > TIMESLICE / 2)
+		adderrbuf("nextDeadline: sleeper not the nearest deadline   ");
+	outSleepQ(&sq, procp[18]);
+	stopQuantum(&tm);
+	if (nextDeadline(&tm) != MAX_INT)
+		adderrbuf("stopQuantum: quantum end still a deadline   ");
+	if (insertBlocked(&onesem, procp[19]) || nextDeadline(&tm) <= 0 || nextDeadline(&tm) > PSECOND)
+		adderrbuf("nextDeadline: pseudo-clock tick not a deadline   ");
+	removeBlocked(&onesem);
+	startQuantum(&tm, 0);
+	insertSleepQ(&sq, procp[18], 0);
+	if (dueTimers(&tm) != (TM_QUANTUM | TM_SLEEP) || nextDeadline(&tm) != 0)
+		adderrbuf("dueTimers: wrong events due   ");
+	qa = mkEmptyProcQ();
+	if (wakeSleepQ(&sq, &qa) != 1 || removeProcQ(&qa) != procp[18])
+		adderrbuf("wakeSleepQ: due sleeper not woken   ");
+	armTimers(&tm);
+	if (nextDeadline(&tm) != MAX_INT || !(tm.tm_active & TM_PARKED))
+		adderrbuf("armTimers: idle timer not parked   ");
+	addokbuf("timer events ok   \n");
+
+	if (termWrite(DEVPERINT, "lost") || termFlush(-1) || !termFlush(0))
+		adderrbuf("termWrite: wrong terminal accepted   ");
+	addokbuf("buffered terminal output ok   \n");
+
 	addokbuf("So Long and Thanks for All the Fish\n");
+	termFlush(0);
 
 }
 
@@ -16,26 +16,372 @@
  *  
  *  - Stack The free list is implemented as a NULL-terminated singly linked list, 
  *    where newly freed PCBs are pushed onto the stack and allocated PCBs are popped off.
+ *  - Per-CPU cache (optional): Built with `PHASE1_SMP`, `allocPcb` and `freePcb` 
+ *    work on a small stack of free PCBs kept by each processor (`pcbCache`), 
+ *    refilled from and drained to the shared free list `PCBREFILL` at a time 
+ *    under `pcbFreeLock`, so most calls take only the uncontended lock of their 
+ *    own cache (`pcbCacheLock`). `allocPcb` and `allocPcbBatch` (which empties 
+ *    the caller's cache first) reclaim the PCBs cached by the other processors, 
+ *    each cache under its own lock, before giving up on an empty shared list, 
+ *    so they fail only when every PCB is allocated. With the bitmap only 
+ *    refills take the lowest free indexes.
+ *  - Bitmap (optional): Built with `PCB_BITMAPALLOC`, free PCBs are instead bits 
+ *    of `pcbFreeMap`, and allocation always takes the lowest free index (found 
+ *    with `firstSetBit`). Live PCBs then stay packed at the front of the pool 
+ *    and the allocation order no longer depends on the order of past frees.
+ *  - Pools: PCBs live in a static array of link and scheduling fields (`pcbPool`), 
+ *    and their processor states in a parallel array (`pcbState`) reached through 
+ *    `p_s`, so queue and tree walks only touch the compact PCB array.
+ *  - Links: Queue and tree links are read and written through `h/link.h`. Built 
+ *    with `LINK_INDEX` they are 16-bit indexes into `pcbPool` instead of pointers, 
+ *    which shrinks the hot part of every PCB; the interface still takes and 
+ *    returns `pcb_PTR`, converted at the boundary.
  *  - Queue: Process queues are implemented as circular doubly linked lists, using 
  *    a tail pointer for efficient insertion and removal (FIFO order).
+ *    Each queued PCB records the address of its queue's tail pointer 
+ *    (`p_queue`), so membership can be checked without walking the queue.
+ *    A tail pointer must therefore stay at a fixed address while its 
+ *    queue is non-empty.
  *  - Tree: Parent-child relationships are represented as a tree structure, where 
  *    each parent maintains a linked list of its children.
  *
  *  This module ensures:
  *  
  *  - Proper initialization of the free list (`initPcbs`).
- *  - Safe allocation (`allocPcb`) and deallocation (`freePcb`) of PCBs.
+ *  - Generation-checked process handles (`pcbToHandle`, `handleToPcb`): a 
+ *    handle names a PCB by its index in `pcbPool` and the generation it 
+ *    had when the handle was made, so it is converted in O(1) and goes 
+ *    stale the moment that PCB is freed.
+ *  - Safe allocation (`allocPcb`) and deallocation (`freePcb`) of PCBs, one 
+ *    at a time or in batches (`allocPcbBatch`, `freePcbBatch`).
+ *  - Optionally (`PCB_SCRUBONFREE`), PCBs are reset when freed rather than 
+ *    when allocated, so the allocation hot path only pops the free list.
+ *  - Optionally (`PHASE1_STATS`), per-operation call, iteration and time 
+ *    counters (see `h/stats.h`).
+ *  - Optionally (`PHASE1_ACCT`), queue wait accounting: PCBs are stamped 
+ *    on insertion and charged the wait on removal (see `h/acct.h`).
+ *  - Optionally (`PHASE1_TRACE`), allocation, free, queue insertion and 
+ *    removal, and tree change events in the trace ring (see `h/trace.h`).
  *  - Efficient insertion (`insertProcQ`) and removal (`removeProcQ`, `outProcQ`) 
  *    from process queues.
- *  - Hierarchical process management (`insertChild`, `removeChild`, `outChild`).
+ *  - Hierarchical process management (`insertChild`, `removeChild`, `outChild`), 
+ *    with O(1) child counts (`childCount`) and O(1) splicing of a whole child 
+ *    list under a new parent (`adoptChildren`), using a last-child pointer.
+ *  - Two tiers of the queue and tree primitives: the public functions 
+ *    validate their arguments once and call the `...Unchecked` ones, 
+ *    which trusted callers (the ready and sleep queues, the ASL, the 
+ *    kernel) may call directly when the preconditions already hold. 
+ *    Built with `PHASE1_DEBUG`, a violated precondition of the unchecked 
+ *    tier panics (see `h/check.h`).
+ *  - Whole-subtree walks and teardown (`walkSubtree`, `outSubtree`) that follow 
+ *    the parent and sibling links instead of recursing, so they use constant 
+ *    stack space at any tree depth.
+ *  - A live list (`pcbLive_h`): every allocated PCB is on a NULL-terminated 
+ *    doubly linked list through `p_live_next`/`p_live_prev`, newest first, 
+ *    joined in `allocPcb` and left in `freePcb` in O(1). Iterating over the 
+ *    live processes (`firstLive`/`nextLive`, `walkLive`) then costs one step 
+ *    per live PCB, and `liveCount` is O(1). With `PHASE1_SMP` the list has 
+ *    its own lock, and iterations must not overlap allocations on other 
+ *    processors.
  *
  *****************************************************************************/
 
 
 #include "../h/pcb.h"
+#include "../h/stats.h"
+#include "../h/acct.h"
+#include "../h/trace.h"
+#include "../h/bitmap.h"
+#include "../h/check.h"
+#include "../h/spin.h"
+#include "../h/port.h"
 
+#ifdef PCB_BITMAPALLOC
+/* Free PCBs: bit i of word w set iff pcbPool[32 * w + i] is free */
+#define PCBMAPWORDS		((MAXPROC + 31) / 32)
+HIDDEN unsigned int pcbFreeMap[PCBMAPWORDS];
+HIDDEN int pcbMapLow;					/* No free bit in the words below it */
+#else
 /* Head of the free PCB list (stores unused PCBs) */
 HIDDEN pcb_PTR pcbFree_h;
+#endif
+
+#ifdef PHASE1_SMP
+HIDDEN spinlock_t pcbFreeLock;			/* Guards the free list (or bitmap) */
+HIDDEN pcb_PTR pcbCache[NCPU][PCBCACHESIZE];	/* Free PCBs kept by each processor */
+HIDDEN int pcbCacheLen[NCPU];
+HIDDEN spinlock_t pcbCacheLock[NCPU];	/* Guards each cache, taken before pcbFreeLock */
+#endif
+
+/* Head of the live list (allocated PCBs, newest first) and its length */
+HIDDEN pcb_PTR pcbLive_h;
+HIDDEN int pcbLiveCount;
+#ifdef PHASE1_SMP
+HIDDEN spinlock_t pcbLiveLock;			/* Guards the live list */
+#endif
+
+#if defined(LINK_INDEX) || defined(PHASE1_TRACE)
+pcb_t pcbPool[MAXPROC];					/* Statically allocated PCB pool, indexed by links */
+#else
+HIDDEN pcb_t pcbPool[MAXPROC];			/* Statically allocated PCB pool */
+#endif
+#ifndef PCB_INLINESTATE
+HIDDEN state_t pcbState[MAXPROC];		/* Processor states of the PCB pool */
+#endif
+
+/***************************************************************
+ *  resetPcb - Resets a PCB to its Freshly Allocated State
+ *
+ *  Clears every link, the semaphore fields and the accounting 
+ *  fields; the processor state binding (`p_s`) is kept.
+ *
+ *  Parameters:
+ *    - p: Pointer to the PCB.
+ ***************************************************************/
+static void resetPcb(pcb_PTR p) {
+	p->p_next = p->p_prev = NILLINK;
+	p->p_parent = p->p_child = p->p_lastChild = NILLINK;
+	p->p_sib_next = p->p_sib_prev = NILLINK;
+	p->p_heapChild = NILLINK;
+	p->p_queue = NULL;
+	p->p_time = 0;
+	p->p_prio = DEFAULTPRIO;
+	p->p_nchild = 0;
+	p->p_delta = 0;
+#ifdef PHASE1_ACCT
+	p->p_qtime = p->p_wait = 0;
+#endif
+	p->p_semAdd = NULL;
+	p->p_semd = NILLINK;
+}
+
+#ifdef PCB_BITMAPALLOC
+/***************************************************************
+ *  takeFreePcb - Takes the Lowest Free PCB off the Bitmap
+ *
+ *  Returns:
+ *    - Pointer to the PCB with the lowest free index, marked 
+ *      as allocated.
+ *    - NULL if every PCB is allocated.
+ ***************************************************************/
+static pcb_PTR takeFreePcb(void) {
+	int bit;
+
+	/* Skip the words without free PCBs */
+	while (pcbMapLow < PCBMAPWORDS && 0 == pcbFreeMap[pcbMapLow])
+		++pcbMapLow;
+	if (pcbMapLow == PCBMAPWORDS) return NULL;
+
+	bit = firstSetBit(pcbFreeMap[pcbMapLow]);
+	pcbFreeMap[pcbMapLow] &= ~(1U << bit);
+
+	return &pcbPool[32 * pcbMapLow + bit];
+}
+
+/***************************************************************
+ *  putFreePcb - Marks a PCB as Free in the Bitmap
+ *
+ *  Parameters:
+ *    - p: Pointer to the PCB.
+ ***************************************************************/
+static void putFreePcb(pcb_PTR p) {
+	int i = p - pcbPool;
+
+	pcbFreeMap[i / 32] |= (1U << (i % 32));
+	pcbMapLow = MIN(pcbMapLow, i / 32);
+}
+#else
+/***************************************************************
+ *  takeFreePcb - Pops the Free List
+ *
+ *  Returns:
+ *    - Pointer to the most recently freed PCB.
+ *    - NULL if every PCB is allocated.
+ ***************************************************************/
+static pcb_PTR takeFreePcb(void) {
+	pcb_PTR p = pcbFree_h;
+
+	if (NULL != p)
+		pcbFree_h = GETPCB(p, p_next);
+	return p;
+}
+
+/***************************************************************
+ *  putFreePcb - Pushes a PCB onto the Free List
+ *
+ *  Parameters:
+ *    - p: Pointer to the PCB.
+ ***************************************************************/
+static void putFreePcb(pcb_PTR p) {
+	SETPCB(p, p_next, pcbFree_h);
+	pcbFree_h = p;
+}
+#endif
+
+#ifdef PHASE1_SMP
+/***************************************************************
+ *  reclaimCaches - Returns the PCBs Cached by Other CPUs to the Pool
+ *
+ *  Each cache is emptied under its own lock, so no two cache 
+ *  locks are ever held at once.
+ *
+ *  Parameters:
+ *    - self: Number of the calling processor, whose cache is kept.
+ ***************************************************************/
+static void reclaimCaches(int self) {
+	int cpu, n;
+
+	for (cpu = 0; cpu < NCPU; ++cpu) {
+		if (cpu == self) continue;
+		LOCK(&pcbCacheLock[cpu]);
+		LOCK(&pcbFreeLock);
+		for (n = 0; n < pcbCacheLen[cpu]; ++n)
+			putFreePcb(pcbCache[cpu][n]);
+		UNLOCK(&pcbFreeLock);
+		pcbCacheLen[cpu] = 0;
+		UNLOCK(&pcbCacheLock[cpu]);
+	}
+}
+
+/***************************************************************
+ *  refillCache - Refills an Empty Cache from the Shared Pool
+ *
+ *  Takes up to `PCBREFILL` PCBs under a single hold of the pool 
+ *  lock. The caller holds the lock of the cache.
+ ***************************************************************/
+static void refillCache(int cpu) {
+	int n;
+	pcb_PTR p;
+
+	LOCK(&pcbFreeLock);
+	for (n = 0; n < PCBREFILL && NULL != (p = takeFreePcb()); ++n)
+		pcbCache[cpu][n] = p;
+	UNLOCK(&pcbFreeLock);
+	pcbCacheLen[cpu] = n;
+}
+
+/***************************************************************
+ *  cacheAllocPcb - Takes a Free PCB from this CPU's Cache
+ *
+ *  An empty cache is first refilled from the shared pool and, 
+ *  if that is empty too, from the other processors' caches.
+ *
+ *  Returns:
+ *    - Pointer to a free PCB.
+ *    - NULL if every PCB is allocated.
+ ***************************************************************/
+static pcb_PTR cacheAllocPcb(void) {
+	int cpu = CPUID();
+	pcb_PTR p = NULL;
+
+	LOCK(&pcbCacheLock[cpu]);
+	if (0 == pcbCacheLen[cpu])
+		refillCache(cpu);
+	if (0 == pcbCacheLen[cpu]) {
+		UNLOCK(&pcbCacheLock[cpu]);
+		reclaimCaches(cpu);
+		LOCK(&pcbCacheLock[cpu]);
+		if (0 == pcbCacheLen[cpu])
+			refillCache(cpu);
+	}
+
+	if (0 < pcbCacheLen[cpu])
+		p = pcbCache[cpu][--pcbCacheLen[cpu]];
+	UNLOCK(&pcbCacheLock[cpu]);
+	return p;
+}
+
+/***************************************************************
+ *  cacheFreePcb - Keeps a Freed PCB in this CPU's Cache
+ *
+ *  A full cache first returns its `PCBREFILL` oldest PCBs to the 
+ *  shared pool, under a single hold of its lock.
+ *
+ *  Parameters:
+ *    - p: Pointer to the freed PCB.
+ ***************************************************************/
+static void cacheFreePcb(pcb_PTR p) {
+	int cpu = CPUID(), n;
+
+	LOCK(&pcbCacheLock[cpu]);
+	if (PCBCACHESIZE == pcbCacheLen[cpu]) {
+		LOCK(&pcbFreeLock);
+		for (n = 0; n < PCBREFILL; ++n)
+			putFreePcb(pcbCache[cpu][n]);
+		UNLOCK(&pcbFreeLock);
+		for (n = PCBREFILL; n < PCBCACHESIZE; ++n)
+			pcbCache[cpu][n - PCBREFILL] = pcbCache[cpu][n];
+		pcbCacheLen[cpu] -= PCBREFILL;
+	}
+
+	pcbCache[cpu][pcbCacheLen[cpu]++] = p;
+	UNLOCK(&pcbCacheLock[cpu]);
+}
+#endif
+
+/***************************************************************
+ *  takeFreeRun - Takes Free PCBs off the Shared Pool at Once
+ *
+ *  Fills `pcbs[i]` to `pcbs[n - 1]`, as far as the pool lasts, 
+ *  under a single hold of its lock.
+ *
+ *  Returns:
+ *    - Index after the last PCB taken.
+ ***************************************************************/
+static int takeFreeRun(pcb_PTR pcbs[], int i, int n) {
+	pcb_PTR iter;
+
+	LOCK(&pcbFreeLock);
+#ifdef PCB_BITMAPALLOC
+	/* Take the lowest free PCBs, in index order */
+	for (; i < n && NULL != (iter = takeFreePcb()); ++i) {
+		STAT_ITER(ST_ALLOCPCBBATCH);
+		pcbs[i] = iter;
+	}
+#else
+	/* Collect the first PCBs of the free list */
+	for (iter = pcbFree_h; i < n && NULL != iter; ++i, iter = GETPCB(iter, p_next)) {
+		STAT_ITER(ST_ALLOCPCBBATCH);
+		pcbs[i] = iter;
+	}
+
+	/* Cut them off with a single update of the head */
+	pcbFree_h = iter;
+#endif
+	UNLOCK(&pcbFreeLock);
+
+	return i;
+}
+
+/***************************************************************
+ *  liveIn - Puts a Newly Allocated PCB on the Live List
+ ***************************************************************/
+static void liveIn(pcb_PTR p) {
+	LOCK(&pcbLiveLock);
+	p->p_live_prev = NILLINK;
+	SETPCB(p, p_live_next, pcbLive_h);
+	if (NULL != pcbLive_h)
+		SETPCB(pcbLive_h, p_live_prev, p);
+	pcbLive_h = p;
+	pcbLiveCount++;
+	UNLOCK(&pcbLiveLock);
+}
+
+/***************************************************************
+ *  liveOut - Takes a PCB being Freed off the Live List
+ ***************************************************************/
+static void liveOut(pcb_PTR p) {
+	LOCK(&pcbLiveLock);
+	if (NILLINK != p->p_live_prev)
+		GETPCB(p, p_live_prev)->p_live_next = p->p_live_next;
+	else
+		pcbLive_h = GETPCB(p, p_live_next);
+	if (NILLINK != p->p_live_next)
+		GETPCB(p, p_live_next)->p_live_prev = p->p_live_prev;
+	p->p_live_next = p->p_live_prev = NILLINK;
+	pcbLiveCount--;
+	UNLOCK(&pcbLiveLock);
+}
 
 /***************************************************************
  *  initPcbs - Initializes the Free PCB List
@@ -48,19 +394,50 @@ HIDDEN pcb_PTR pcbFree_h;
  *  - The function must be called once during system initialization.
  *  - It uses a static array to store all PCBs since dynamic 
  *    allocation (e.g., `malloc()`) is not available.
+ *  - Each PCB's processor state is bound once, here, to its slot 
+ *    of the static state pool (or to its own `p_state` with 
+ *    `PCB_INLINESTATE`); `p_s` never changes afterwards.
+ *  - Generations survive re-initialization, so handles issued 
+ *    before it stay stale (see `pcbToHandle`).
  * 
  *  Parameters:
  *    - None
  ***************************************************************/
 void initPcbs(void) {
 	int i;
-	static pcb_t pcbPool[MAXPROC];	/* Statically allocated PCB pool */
-	pcbFree_h = NULL;				/* Ensure list starts empty */
+	STAT_ENTER(ST_INITPCBS)
+#ifdef PCB_BITMAPALLOC
+	for (i = 0; i < PCBMAPWORDS; ++i)
+		pcbFreeMap[i] = 0;				/* Ensure the bitmap starts empty */
+	pcbMapLow = 0;
+#else
+	pcbFree_h = NULL;					/* Ensure list starts empty */
+#endif
+	pcbLive_h = NULL;					/* No PCB is allocated */
+	pcbLiveCount = 0;
+#ifdef PHASE1_SMP
+	INITLOCK(&pcbFreeLock);
+	INITLOCK(&pcbLiveLock);
+	for (i = 0; i < NCPU; ++i) {
+		INITLOCK(&pcbCacheLock[i]);
+		pcbCacheLen[i] = 0;				/* Every cache starts empty */
+	}
+#endif
 
 	/* Link all PCBs into the free list */
 	for (i = 0; i < MAXPROC; ++i) {
-		pcbPool[i].p_next = pcbFree_h;	/* New PCB points to the current head */
-		pcbFree_h = &pcbPool[i];		/* Move head to the new PCB */
+#ifdef PCB_INLINESTATE
+		pcbPool[i].p_s = &(pcbPool[i].p_state);
+#else
+		pcbPool[i].p_s = &pcbState[i];
+#endif
+#ifdef PCB_SCRUBONFREE
+		resetPcb(&pcbPool[i]);			/* Free PCBs are kept scrubbed */
+#endif
+		pcbPool[i].p_gen |= 1;			/* End the life of a PCB still allocated */
+		pcbPool[i].p_gen++;
+		pcbPool[i].p_live_next = pcbPool[i].p_live_prev = NILLINK;
+		putFreePcb(&pcbPool[i]);		/* Onto the free list */
     }		
 
 }
@@ -74,17 +451,38 @@ void initPcbs(void) {
  *
  *  - The PCB is added to the head of `pcbFree_h`, maintaining 
  *    the Last-In-First-Out (LIFO) order (stack behavior).
+ *    With `PCB_BITMAPALLOC` its bit is set instead.
  *  - If `p` is `NULL`, the function does nothing.
+ *  - `p` must be allocated: with `PHASE1_DEBUG`, freeing it twice 
+ *    panics (see `h/check.h`); otherwise the second free is ignored, 
+ *    so it cannot corrupt the free list.
+ *  - With `PCB_SCRUBONFREE`, the PCB's fields are reset here 
+ *    instead of in `allocPcb`.
  *
  *  Parameters:
  *    - p: Pointer to the PCB to be freed.
  ***************************************************************/
 void freePcb(pcb_PTR p) {
-	if (NULL == p) return;	/* Ignore NULL input */
+	STAT_ENTER(ST_FREEPCB)
+	/* Ignore NULL input; a PCB already free (even generation) is a double free */
+	if (NULL == p) return;
+	REQUIRE(p->p_gen & 1);
+	if (0 == (p->p_gen & 1)) return;
+
+	liveOut(p);
+
+#ifdef PCB_SCRUBONFREE
+	resetPcb(p);
+#endif
+	p->p_gen++;				/* Outstanding handles become stale */
+	TRACE_EVENT(TR_FREE, p, NULL);
 
 	/* Insert PCB back into the free list */
-	p->p_next = pcbFree_h;
-	pcbFree_h = p;
+#ifdef PHASE1_SMP
+	cacheFreePcb(p);
+#else
+	putFreePcb(p);
+#endif
 }
 
 /***************************************************************
@@ -94,6 +492,8 @@ void freePcb(pcb_PTR p) {
  *  from `pcbFree_h`. If no PCBs are available, it returns `NULL`.
  *
  *  - The removed PCB is disconnected from the free list.
+ *    With `PCB_BITMAPALLOC` it is the free PCB with the lowest 
+ *    index instead.
  *  - All its fields are reset to default values before use.
  *
  *  Parameters:
@@ -105,24 +505,195 @@ void freePcb(pcb_PTR p) {
  ***************************************************************/
 pcb_PTR allocPcb(void) {
 	pcb_PTR pcbRm;
-	pcbRm = pcbFree_h; /* Get the first available PCB */
+	STAT_ENTER(ST_ALLOCPCB)
+	/* Remove the first available PCB from the free list */
+#ifdef PHASE1_SMP
+	pcbRm = cacheAllocPcb();
+#else
+	pcbRm = takeFreePcb();
+#endif
 
 	/* No PCBs available */
 	if (NULL == pcbRm) return NULL;
 
-	/* Remove the first PCB from the free list */
-	pcbFree_h = pcbRm->p_next;
+	pcbRm->p_gen++;			/* A new life, with a new handle */
+	liveIn(pcbRm);
+	TRACE_EVENT(TR_ALLOC, pcbRm, NULL);
 
+#ifdef PCB_SCRUBONFREE
+	/* Already scrubbed by freePcb, except for the free list link */
+	pcbRm->p_next = NILLINK;
+#else
 	/* Reset all PCB fields */
-	pcbRm->p_next = pcbRm->p_prev = NULL;
-	pcbRm->p_parent = pcbRm->p_child = NULL;
-	pcbRm->p_sib_next = pcbRm->p_sib_prev = NULL;
-	pcbRm->p_time = 0;
-	pcbRm->p_semAdd = NULL;
+	resetPcb(pcbRm);
+#endif
 
 	return pcbRm;
 }
 
+/***************************************************************
+ *  allocPcbBatch - Allocates Several PCBs at Once
+ *
+ *  This function detaches up to `n` PCBs from the head of 
+ *  `pcbFree_h` in one operation and stores them in `pcbs`. Each 
+ *  is reset exactly as by `allocPcb`. With `PHASE1_SMP`, the 
+ *  PCBs cached by the calling processor are taken first, and 
+ *  those cached by the others once the free list runs out.
+ *
+ *  Parameters:
+ *    - pcbs: Array receiving the allocated PCBs.
+ *    - n:    Number of PCBs wanted.
+ *
+ *  Returns:
+ *    - Number of PCBs allocated (less than `n` only if the free 
+ *      list ran out).
+ ***************************************************************/
+int allocPcbBatch(pcb_PTR pcbs[], int n) {
+	int i = 0;
+#ifdef PHASE1_SMP
+	int cpu = CPUID();
+#endif
+	STAT_ENTER(ST_ALLOCPCBBATCH)
+
+#ifdef PHASE1_SMP
+	/* This processor's cached PCBs go first, the other caches last */
+	LOCK(&pcbCacheLock[cpu]);
+	while (i < n && 0 < pcbCacheLen[cpu])
+		pcbs[i++] = pcbCache[cpu][--pcbCacheLen[cpu]];
+	UNLOCK(&pcbCacheLock[cpu]);
+
+	i = takeFreeRun(pcbs, i, n);
+	if (i < n) {
+		reclaimCaches(cpu);
+		i = takeFreeRun(pcbs, i, n);
+	}
+#else
+	i = takeFreeRun(pcbs, i, n);
+#endif
+
+	/* Prepare them for use */
+	for (n = 0; n < i; ++n) {
+		pcbs[n]->p_gen++;
+		liveIn(pcbs[n]);
+		TRACE_EVENT(TR_ALLOC, pcbs[n], NULL);
+#ifdef PCB_SCRUBONFREE
+		pcbs[n]->p_next = NILLINK;
+#else
+		resetPcb(pcbs[n]);
+#endif
+	}
+
+	return i;
+}
+
+/***************************************************************
+ *  freePcbBatch - Returns Several PCBs to the Free List at Once
+ *
+ *  This function chains the `n` PCBs of `pcbs` together and 
+ *  pushes the whole chain onto `pcbFree_h` with a single update 
+ *  of the head. NULL entries are ignored; every other entry must 
+ *  be allocated, as for `freePcb`, and is skipped if it is not.
+ *
+ *  Parameters:
+ *    - pcbs: Array of PCBs to be freed.
+ *    - n:    Number of entries in `pcbs`.
+ ***************************************************************/
+void freePcbBatch(pcb_PTR pcbs[], int n) {
+	int i;
+#ifndef PCB_BITMAPALLOC
+	pcb_PTR head;
+#endif
+	STAT_ENTER(ST_FREEPCBBATCH)
+
+	LOCK(&pcbFreeLock);
+#ifdef PCB_BITMAPALLOC
+	/* Set the bit of every PCB */
+	for (i = 0; i < n; ++i) {
+		STAT_ITER(ST_FREEPCBBATCH);
+		if (NULL == pcbs[i]) continue;
+		REQUIRE(pcbs[i]->p_gen & 1);
+		if (0 == (pcbs[i]->p_gen & 1)) continue;
+		liveOut(pcbs[i]);
+#ifdef PCB_SCRUBONFREE
+		resetPcb(pcbs[i]);
+#endif
+		pcbs[i]->p_gen++;
+		TRACE_EVENT(TR_FREE, pcbs[i], NULL);
+		putFreePcb(pcbs[i]);
+	}
+#else
+	/* Chain the PCBs back to front, ending on the current free list */
+	head = pcbFree_h;
+	for (i = n - 1; i >= 0; --i) {
+		STAT_ITER(ST_FREEPCBBATCH);
+		if (NULL == pcbs[i]) continue;
+		REQUIRE(pcbs[i]->p_gen & 1);
+		if (0 == (pcbs[i]->p_gen & 1)) continue;
+		liveOut(pcbs[i]);
+#ifdef PCB_SCRUBONFREE
+		resetPcb(pcbs[i]);
+#endif
+		pcbs[i]->p_gen++;
+		TRACE_EVENT(TR_FREE, pcbs[i], NULL);
+		SETPCB(pcbs[i], p_next, head);
+		head = pcbs[i];
+	}
+
+	pcbFree_h = head;
+#endif
+	UNLOCK(&pcbFreeLock);
+}
+
+/***************************************************************
+ *  pcbToHandle - Returns the Handle of an Allocated PCB
+ *
+ *  The handle combines the PCB's index in the pool with its 
+ *  current generation: it names this life of the PCB only.
+ *
+ *  - Generations are odd while a PCB is allocated and are 
+ *    increased on every allocation and free; they wrap after 
+ *    2^(31 - PIDINDEXBITS) lives of the same PCB, the only case 
+ *    in which a stale handle can be mistaken for a live one.
+ *
+ *  Parameters:
+ *    - p: Pointer to the PCB.
+ *
+ *  Returns:
+ *    - The handle of `p`.
+ *    - NOPROCID if `p` is NULL or free.
+ ***************************************************************/
+procid_t pcbToHandle(pcb_PTR p) {
+	STAT_ENTER(ST_PCBTOHANDLE)
+	if (NULL == p || 0 == (p->p_gen & 1)) return NOPROCID;
+
+	return (p->p_gen << PIDINDEXBITS) | (procid_t) (p - pcbPool);
+}
+
+/***************************************************************
+ *  handleToPcb - Returns the PCB Named by a Handle
+ *
+ *  Parameters:
+ *    - pid: Handle returned by `pcbToHandle`.
+ *
+ *  Returns:
+ *    - Pointer to the PCB, if it is still in the life the handle 
+ *      was made for.
+ *    - NULL if the handle is invalid or stale (the PCB was freed, 
+ *      and maybe reallocated, since).
+ ***************************************************************/
+pcb_PTR handleToPcb(procid_t pid) {
+	pcb_PTR p;
+	STAT_ENTER(ST_HANDLETOPCB)
+
+	if ((pid & PIDINDEXMASK) >= MAXPROC) return NULL;
+
+	/* The PCB must be allocated, and in the same generation */
+	p = &pcbPool[pid & PIDINDEXMASK];
+	if (0 == (p->p_gen & 1) || pid != ((p->p_gen << PIDINDEXBITS) | (pid & PIDINDEXMASK)))
+		return NULL;
+	return p;
+}
+
 /***************************************************************
  *  mkEmptyProcQ - Creates an Empty Process Queue
  *
@@ -139,6 +710,7 @@ pcb_PTR allocPcb(void) {
  *    - NULL (indicating an empty queue).
  ***************************************************************/
 pcb_PTR mkEmptyProcQ(void) {
+	STAT_ENTER(ST_MKEMPTYPROCQ)
     return (NULL);
 }
 
@@ -156,9 +728,39 @@ pcb_PTR mkEmptyProcQ(void) {
  *    - 0 (FALSE) if the queue contains processes.
  ***************************************************************/
 int emptyProcQ(pcb_PTR tp) {
+	STAT_ENTER(ST_EMPTYPROCQ)
 	return (NULL == tp);
 }
 
+/***************************************************************
+ *  insertProcQUnchecked - insertProcQ for Trusted Callers
+ *
+ *  Requires `tp` and `p` to be non-NULL and `p` to be in no queue.
+ ***************************************************************/
+void insertProcQUnchecked(pcb_PTR *tp, pcb_PTR p) {
+	STAT_ENTER(ST_INSERTPROCQ)
+	REQUIRE(NULL != tp && NULL != p && NULL == p->p_queue);
+
+	/* Record the owning queue */
+	p->p_queue = tp;
+	ACCT_ENQUEUE(p);
+	TRACE_EVENT(TR_ENQUEUE, p, tp);
+
+	/* If the queue is empty, initialize it with the new process */
+	if (emptyProcQ(*tp)) {
+		*tp = p;
+		p->p_prev = p->p_next = PCBLINK(p);	/* Circular list: p points to itself */
+        return;
+	}
+
+	/* Insert new PCB at the tail */
+	p->p_next = (*tp)->p_next;		/* New PCB's next points to the head */
+	SETPCB(p, p_prev, *tp);			/* New PCB's prev points to the current tail */
+	SETPCB(GETPCB(*tp, p_next), p_prev, p);	/* Update the head's prev to point to new PCB */
+	SETPCB(*tp, p_next, p);			/* Update the tail's next to point to new PCB */
+	*tp = p;						/* Update tail pointer to the newly inserted PCB */
+}
+
 /***************************************************************
  *  insertProcQ - Inserts a PCB into a Process Queue (FIFO)
  *
@@ -168,6 +770,7 @@ int emptyProcQ(pcb_PTR tp) {
  *  - If the queue is empty, `p` becomes both the head and tail.
  *  - Otherwise, `p` is inserted after the current tail, 
  *    ensuring FIFO (First-In-First-Out) order.
+ *  - `p` is tagged with `tp` as its owning queue.
  *
  *  Parameters:
  *    - tp: Pointer to the tail of the queue.
@@ -177,19 +780,7 @@ void insertProcQ(pcb_PTR *tp, pcb_PTR p) {
 	/* Ignore NULL process */
 	if (NULL == p || NULL == tp) return;
 
-	/* If the queue is empty, initialize it with the new process */
-	if (emptyProcQ(*tp)) {
-		*tp = p;
-		p->p_prev = p->p_next = p;	/* Circular list: p points to itself */
-        return;
-	}
-
-	/* Insert new PCB at the tail */
-	p->p_next = (*tp)->p_next;		/* New PCB's next points to the head */
-	p->p_prev = *tp;				/* New PCB's prev points to the current tail */
-	(*tp)->p_next->p_prev = p;		/* Update the head's prev to point to new PCB */
-	(*tp)->p_next = p;				/* Update the tail's next to point to new PCB */
-	*tp = p;						/* Update tail pointer to the newly inserted PCB */
+	insertProcQUnchecked(tp, p);
 }
 	
 /***************************************************************
@@ -210,11 +801,43 @@ void insertProcQ(pcb_PTR *tp, pcb_PTR p) {
  *    - NULL if the queue is empty.
  ***************************************************************/
 pcb_PTR removeProcQ(pcb_PTR *tp) {
+	STAT_ENTER(ST_REMOVEPROCQ)
 	/* Return NULL if the queue is empty */
-	if (emptyProcQ(*tp) || NULL == tp) return NULL;
+	if (NULL == tp || emptyProcQ(*tp)) return NULL;
 	
 	/* Remove and return the first PCB (head) from the queue */
-	return outProcQ(tp, headProcQ(*tp));
+	return outProcQUnchecked(tp, headProcQ(*tp));
+}
+
+/***************************************************************
+ *  outProcQUnchecked - outProcQ for Trusted Callers
+ *
+ *  Requires `p` to be non-NULL and in the queue of `tp`.
+ ***************************************************************/
+pcb_PTR outProcQUnchecked(pcb_PTR *tp, pcb_PTR p) {
+	STAT_ENTER(ST_OUTPROCQ)
+	REQUIRE(NULL != p && NULL != tp && p->p_queue == tp);
+
+	/* Case 1: p is the only element in the queue */
+	if (p == GETPCB(p, p_next)) 
+		*tp = NULL;									/* Queue is now empty */
+	else {
+		GETPCB(p, p_prev)->p_next = p->p_next;		/* Connect previous node to the next node */
+		GETPCB(p, p_next)->p_prev = p->p_prev;		/* Connect next node to the previous node */
+
+		/* Case 2: p is the tail of the queue */
+		if (p == *tp) 
+			*tp = GETPCB(p, p_prev);				/* Update tail pointer */
+	}
+
+	/* Reset removed pcb's links and ownership */
+	p->p_next = p->p_prev = NILLINK;
+	p->p_queue = NULL;
+	ACCT_DEQUEUE(p);
+	TRACE_EVENT(TR_DEQUEUE, p, tp);
+
+	/* Return the removed PCB */
+	return p;
 }
 
 /***************************************************************
@@ -224,6 +847,8 @@ pcb_PTR removeProcQ(pcb_PTR *tp) {
  *  circularly linked process queue whose tail pointer is `tp`.
  *
  *  - If `p` is not in the queue, the function returns `NULL`.
+ *  - Membership is decided by the `p_queue` tag set in `insertProcQ`, 
+ *    so neither the check nor the unlink walks the queue (O(1)).
  *  - If `p` is found, it is removed while maintaining the 
  *    circular structure of the queue.
  *  - If `p` was the tail, the tail pointer is updated.
@@ -237,50 +862,11 @@ pcb_PTR removeProcQ(pcb_PTR *tp) {
  *    - NULL if `p` is not in the queue or if the queue is empty.
  ***************************************************************/
 pcb_PTR outProcQ(pcb_PTR *tp, pcb_PTR p) {
-	pcb_PTR iter;
-
-	/* Case 1: Queue is empty, tp is NULL, or p is NULL */
-	if (NULL == p || emptyProcQ(*tp) || NULL == tp) return NULL;
-
-	/* Case 2: p is the only element in the queue */
-	if (*tp == (*tp)->p_next) {
-		if (*tp == p) {	/* Only element matches */
-			*tp = NULL;	/* Queue is now empty */
-			return p;
-		}
-
-		return NULL;	/* p was not found in the queue */
-	}
-
-	/* Case 3: p is the tail of the queue */
-	if (p == *tp) {
-		(*tp)->p_prev->p_next = (*tp)->p_next;	/* Connect previous node to the next node */
-		(*tp)->p_next->p_prev = (*tp)->p_prev;	/* Connect next node to the previous node */
-
-		iter = *tp;								/* Use iter as dummy for resetting links */
-		iter->p_next = iter->p_prev = NULL;
-
-		*tp = (*tp)->p_prev;					/* Update tail pointer */
+	/* Case 1: tp is NULL, p is NULL, or p does not belong to this queue
+	 * (a queued PCB's tag also implies the queue is not empty) */
+	if (NULL == p || NULL == tp || p->p_queue != tp) return NULL;
 
-		return p;
-	}
-
-	/* Case 4: p is somewhere in the queue (not the tail) */
-	for (iter = (*tp)->p_next; iter != *tp && iter != p; iter = iter->p_next);
-
-	/* If p is found, remove it from the queue */
-	if (iter == p) {
-		iter->p_prev->p_next = iter->p_next;	/* Connect the previous node to the next node */
-		iter->p_next->p_prev = iter->p_prev;	/* Connect the next node to the previous node */
-		/* Reset removed pcb's links */
-		iter->p_next = iter->p_prev = NULL;
-
-		/* Return the removed PCB */
-		return p;
-	}
-
-	/* Case 5: p was not found in the queue */
-	return NULL;
+	return outProcQUnchecked(tp, p);
 }
 
 
@@ -301,11 +887,45 @@ pcb_PTR outProcQ(pcb_PTR *tp, pcb_PTR p) {
  *    - NULL if the queue is empty.
  ***************************************************************/
 pcb_PTR headProcQ(pcb_PTR tp) {
+	STAT_ENTER(ST_HEADPROCQ)
 	/* Return NULL if the queue is empty */
 	if (emptyProcQ(tp)) return NULL;
 
 	/* Return a pointer to the first PCB (head) without removing it */
-	return tp->p_next;
+	return GETPCB(tp, p_next);
+}
+
+/***************************************************************
+ *  unblockProcQ - Takes Ownership of a Detached Blocked Queue
+ *
+ *  This function makes a process queue detached from a semaphore 
+ *  (see `removeAllBlocked`) usable as an ordinary queue whose 
+ *  tail pointer is `tp`.
+ *
+ *  - Every PCB in the queue has `p_semAdd` and `p_semd` cleared 
+ *    and is re-tagged as owned by `tp`.
+ *  - The cost is one pass of pointer writes over the queue; 
+ *    no PCB is unlinked or relinked.
+ *
+ *  Parameters:
+ *    - tp: Pointer to the tail of the detached queue.
+ ***************************************************************/
+void unblockProcQ(pcb_PTR *tp) {
+	pcb_PTR iter;
+	STAT_ENTER(ST_UNBLOCKPROCQ)
+
+	/* Nothing to do for an empty queue */
+	if (NULL == tp || emptyProcQ(*tp)) return;
+
+	/* Visit every PCB once, from the head around to the tail */
+	iter = *tp;
+	do {
+		STAT_ITER(ST_UNBLOCKPROCQ);
+		iter = GETPCB(iter, p_next);
+		iter->p_semAdd = NULL;
+		iter->p_semd = NILLINK;
+		iter->p_queue = tp;
+	} while (iter != *tp);
 }
 
 /***************************************************************
@@ -326,7 +946,37 @@ pcb_PTR headProcQ(pcb_PTR tp) {
  *    - 0 (FALSE) if `p` has at least one child.
  ***************************************************************/
 int emptyChild(pcb_PTR p) {
-	return (NULL == p->p_child);
+	STAT_ENTER(ST_EMPTYCHILD)
+	return (NILLINK == p->p_child);
+}
+
+/***************************************************************
+ *  insertChildUnchecked - insertChild for Trusted Callers
+ *
+ *  Requires `prnt` and `p` to be non-NULL and `p` to have no 
+ *  parent.
+ ***************************************************************/
+void insertChildUnchecked(pcb_PTR prnt, pcb_PTR p) {
+	STAT_ENTER(ST_INSERTCHILD)
+	REQUIRE(NULL != prnt && NULL != p && NILLINK == p->p_parent);
+
+	/* Set the parent of the new child */
+	SETPCB(p, p_parent, prnt);
+	TRACE_EVENT(TR_INSCHILD, p, prnt);
+
+	prnt->p_nchild++;
+
+	/* If the parent has no children, insert p as the first child */
+	if (emptyChild(prnt)) {
+		prnt->p_child = prnt->p_lastChild = PCBLINK(p);
+		p->p_sib_next = p->p_sib_prev = NILLINK;	/* No siblings */
+		return;
+	}
+	/* Insert p at the front of the sibling list*/
+	p->p_sib_next = prnt->p_child;	/* New child's next sibling is the current first child */
+	SETPCB(GETPCB(p, p_sib_next), p_sib_prev, p);	/* Update previous pointer of the old first child */
+	SETPCB(prnt, p_child, p);		/* Update parent's first child pointer to p */
+	p->p_sib_prev = NILLINK;		/* New first child has no previous sibling */
 }
 
 /***************************************************************
@@ -352,20 +1002,7 @@ void insertChild(pcb_PTR prnt, pcb_PTR p) {
 	/* Do nothing if parent or child is NULL */
 	if (NULL == prnt || NULL == p) return;
 
-	/* Set the parent of the new child */
-	p->p_parent = prnt;
-
-	/* If the parent has no children, insert p as the first child */
-	if (emptyChild(prnt)) {
-		prnt->p_child = p;
-		p->p_sib_next = p->p_sib_prev = NULL;	/* No siblings */
-		return;
-	}
-	/* Insert p at the front of the sibling list*/
-	p->p_sib_next = prnt->p_child;	/* New child's next sibling is the current first child */
-	p->p_sib_next->p_sib_prev = p;	/* Update previous pointer of the old first child */
-	prnt->p_child = p;				/* Update parent's first child pointer to p */
-	p->p_sib_prev = NULL;			/* New first child has no previous sibling */
+	insertChildUnchecked(prnt, p);
 }
 
 /***************************************************************
@@ -386,11 +1023,47 @@ void insertChild(pcb_PTR prnt, pcb_PTR p) {
  *    - NULL if `p` is NULL or has no children.
  ***************************************************************/
 pcb_PTR removeChild(pcb_PTR p) {
+	STAT_ENTER(ST_REMOVECHILD)
 	/* Return NULL if no children */
 	if (NULL == p || emptyChild(p)) return NULL;
 
 	/* Remove and return the first (oldest) child */
-	return outChild(p->p_child); 
+	return outChildUnchecked(GETPCB(p, p_child)); 
+}
+
+/***************************************************************
+ *  outChildUnchecked - outChild for Trusted Callers
+ *
+ *  Requires `p` to be non-NULL and to have a parent.
+ ***************************************************************/
+pcb_PTR outChildUnchecked(pcb_PTR p) {
+	pcb_PTR prnt;
+	STAT_ENTER(ST_OUTCHILD)
+	REQUIRE(NULL != p && NILLINK != p->p_parent);
+	prnt = GETPCB(p, p_parent);
+	TRACE_EVENT(TR_OUTCHILD, p, prnt);
+
+	/* If p is the first child, update the parent's child pointer */
+	if (GETPCB(prnt, p_child) == p) 
+		prnt->p_child = p->p_sib_next;			/* The next sibling becomes the first child */
+
+	/* If p is the last child, the previous sibling becomes the last */
+	if (GETPCB(prnt, p_lastChild) == p)
+		prnt->p_lastChild = p->p_sib_prev;
+	prnt->p_nchild--;
+
+	/* Update sibling pointers to remove p from the sibling list */
+	if (p->p_sib_prev != NILLINK)
+		GETPCB(p, p_sib_prev)->p_sib_next = p->p_sib_next;	/* Skip p in the previous sibling's next */
+
+	if (p->p_sib_next != NILLINK)
+		GETPCB(p, p_sib_next)->p_sib_prev = p->p_sib_prev;	/* Skip p in the next sibling's previous */
+
+	/* Disconnect p from the parent and sibling links */
+	p->p_sib_next = p->p_sib_prev = p->p_parent = NILLINK;
+
+	/* Return the removed child */
+	return p;
 }
 
 /***************************************************************
@@ -415,22 +1088,246 @@ pcb_PTR removeChild(pcb_PTR p) {
  ***************************************************************/
 pcb_PTR outChild(pcb_PTR p) {
 	/* Return NULL if p is NULL or has no parent */
-	if (NULL == p || NULL == p->p_parent) return NULL;
+	if (NULL == p || NILLINK == p->p_parent) return NULL;
 
-	/* If p is the first child, update the parent's child pointer */
-	if (p->p_parent->p_child == p) 
-		p->p_parent->p_child = p->p_sib_next;	/* The next sibling becomes the first child */
+	return outChildUnchecked(p);
+}
 
-	/* Update sibling pointers to remove p from the sibling list */
-	if (p->p_sib_prev != NULL)
-		p->p_sib_prev->p_sib_next = p->p_sib_next;	/* Skip p in the previous sibling's next */
+#ifdef PHASE1_DEBUG
+/***************************************************************
+ *  isAncestor - Checks if a PCB is Above Another in the Tree
+ *
+ *  Parameters:
+ *    - a: Candidate ancestor.
+ *    - p: PCB to walk up from.
+ *
+ *  Returns:
+ *    - TRUE if `a` is a (possibly indirect) parent of `p`.
+ *    - FALSE otherwise.
+ ***************************************************************/
+static int isAncestor(pcb_PTR a, pcb_PTR p) {
+	for (p = GETPCB(p, p_parent); NULL != p; p = GETPCB(p, p_parent))
+		if (p == a) return TRUE;
+	return FALSE;
+}
+#endif
 
-	if (p->p_sib_next != NULL)
-		p->p_sib_next->p_sib_prev = p->p_sib_prev;	/* Skip p in the next sibling's previous */
+/***************************************************************
+ *  adoptChildren - Moves Every Child of a PCB Under Another
+ *
+ *  This function appends the whole child list of `p`, in order, 
+ *  after the last child of `prnt` (e.g. orphans adopted by an 
+ *  ancestor when `p` dies, or a process group changing leader).
+ *
+ *  - The sibling lists are joined in constant time through the 
+ *    last-child pointers; only the `p_parent` field of each moved 
+ *    child is rewritten (one store per child, no unlinking).
+ *  - `prnt` must not be one of the descendants of `p`, or the 
+ *    move would close a cycle: with `PHASE1_DEBUG`, the parents 
+ *    of `prnt` are walked up to the root to check it, in O(depth) 
+ *    (see `h/check.h`).
+ *
+ *  Parameters:
+ *    - prnt: Pointer to the new parent.
+ *    - p:    Pointer to the PCB whose children move.
+ ***************************************************************/
+void adoptChildren(pcb_PTR prnt, pcb_PTR p) {
+	pcb_PTR child;
+	STAT_ENTER(ST_ADOPTCHILDREN)
 
-	/* Disconnect p from the parent and sibling links */
-	p->p_sib_next = p->p_sib_prev = p->p_parent = NULL;
+	/* Nothing to move */
+	if (NULL == prnt || NULL == p || prnt == p || emptyChild(p)) return;
+	REQUIRE(!isAncestor(p, prnt));
+	TRACE_EVENT(TR_ADOPT, p, prnt);
 
-	/* Return the removed child */
-	return p;
-}
\ No newline at end of file
+	/* The moved children now belong to prnt */
+	for (child = GETPCB(p, p_child); NULL != child; child = GETPCB(child, p_sib_next)) {
+		STAT_ITER(ST_ADOPTCHILDREN);
+		SETPCB(child, p_parent, prnt);
+	}
+
+	/* Join p's list after prnt's last child, or make it prnt's list */
+	if (emptyChild(prnt))
+		prnt->p_child = p->p_child;
+	else {
+		GETPCB(prnt, p_lastChild)->p_sib_next = p->p_child;
+		GETPCB(p, p_child)->p_sib_prev = prnt->p_lastChild;
+	}
+	prnt->p_lastChild = p->p_lastChild;
+	prnt->p_nchild += p->p_nchild;
+
+	/* p is left without children */
+	p->p_child = p->p_lastChild = NILLINK;
+	p->p_nchild = 0;
+}
+
+/***************************************************************
+ *  childCount - Returns the Number of Children of a PCB
+ *
+ *  The count is kept up to date by the tree operations, so no 
+ *  sibling list is walked (O(1)).
+ *
+ *  Parameters:
+ *    - p: Pointer to the process.
+ *
+ *  Returns:
+ *    - The number of children of `p` (0 if `p` is NULL).
+ ***************************************************************/
+int childCount(pcb_PTR p) {
+	STAT_ENTER(ST_CHILDCOUNT)
+	return (NULL == p) ? 0 : p->p_nchild;
+}
+
+/***************************************************************
+ *  walkSubtree - Visits Every PCB of a Subtree
+ *
+ *  This function calls `visit(p, arg)` on `root` and on every 
+ *  descendant of `root`, parents before their children 
+ *  (preorder).
+ *
+ *  - The walk follows `p_child`, `p_sib_next` and `p_parent` 
+ *    instead of recursing: O(subtree size) time and constant 
+ *    stack space.
+ *  - `visit` must not change the process tree.
+ *
+ *  Parameters:
+ *    - root:  Root of the subtree.
+ *    - visit: Function called once per PCB.
+ *    - arg:   Opaque argument passed to `visit`.
+ ***************************************************************/
+void walkSubtree(pcb_PTR root, pcbVisit_t visit, void *arg) {
+	pcb_PTR iter;
+	STAT_ENTER(ST_WALKSUBTREE)
+
+	if (NULL == root) return;
+
+	iter = root;
+	while (TRUE) {
+		STAT_ITER(ST_WALKSUBTREE);
+		visit(iter, arg);
+
+		/* Descend to the first child when there is one */
+		if (!emptyChild(iter)) {
+			iter = GETPCB(iter, p_child);
+			continue;
+		}
+
+		/* Otherwise climb until a node with a next sibling */
+		while (iter != root && NILLINK == iter->p_sib_next)
+			iter = GETPCB(iter, p_parent);
+
+		/* Back at the root: the whole subtree was visited */
+		if (iter == root) return;
+
+		iter = GETPCB(iter, p_sib_next);
+	}
+}
+
+/***************************************************************
+ *  outSubtree - Detaches a Whole Subtree, One PCB at a Time
+ *
+ *  This function removes `root` from its parent and takes the 
+ *  subtree apart, calling `visit(p, arg)` on each PCB right 
+ *  after it has been detached. Children are always detached 
+ *  before their parent, and `root` comes last.
+ *
+ *  - When `visit` is called, the PCB has no parent, siblings or 
+ *    children left, so `visit` may remove it from its queue or 
+ *    semaphore (`outProcQ`, `outBlocked`) and `freePcb` it.
+ *  - Each PCB is reached by descending from its parent once: 
+ *    O(subtree size) time and constant stack space.
+ *
+ *  Parameters:
+ *    - root:  Root of the subtree.
+ *    - visit: Function called once per detached PCB.
+ *    - arg:   Opaque argument passed to `visit`.
+ ***************************************************************/
+void outSubtree(pcb_PTR root, pcbVisit_t visit, void *arg) {
+	pcb_PTR iter, prnt;
+	STAT_ENTER(ST_OUTSUBTREE)
+
+	if (NULL == root) return;
+
+	/* Cut the subtree off the rest of the tree */
+	outChild(root);
+
+	iter = root;
+	while (TRUE) {
+		/* Descend to a leaf */
+		STAT_ITER(ST_OUTSUBTREE);
+		while (!emptyChild(iter))
+			iter = GETPCB(iter, p_child);
+
+		if (iter == root) break;
+
+		/* Detach the leaf and continue from its parent */
+		prnt = GETPCB(iter, p_parent);
+		outChildUnchecked(iter);
+		visit(iter, arg);
+		iter = prnt;
+	}
+
+	visit(root, arg);
+}
+
+/***************************************************************
+ *  firstLive - Starts an Iteration over the Allocated PCBs
+ *
+ *  Together with `nextLive`, visits every allocated PCB once, 
+ *  newest first. A PCB may be freed once its successor has been 
+ *  fetched; PCBs allocated meanwhile are not visited.
+ *
+ *  Returns:
+ *    - The most recently allocated PCB.
+ *    - NULL if no PCB is allocated.
+ ***************************************************************/
+pcb_PTR firstLive(void) {
+	STAT_ENTER(ST_FIRSTLIVE)
+	return pcbLive_h;
+}
+
+/***************************************************************
+ *  nextLive - Continues an Iteration over the Allocated PCBs
+ *
+ *  Parameters:
+ *    - p: PCB returned by `firstLive` or `nextLive`.
+ *
+ *  Returns:
+ *    - The next allocated PCB, allocated before `p`.
+ *    - NULL at the end of the list, or if `p` is NULL.
+ ***************************************************************/
+pcb_PTR nextLive(pcb_PTR p) {
+	STAT_ENTER(ST_NEXTLIVE)
+	if (NULL == p) return NULL;
+
+	return GETPCB(p, p_live_next);
+}
+
+/***************************************************************
+ *  liveCount - Returns the Number of Allocated PCBs
+ ***************************************************************/
+int liveCount(void) {
+	STAT_ENTER(ST_LIVECOUNT)
+	return pcbLiveCount;
+}
+
+/***************************************************************
+ *  walkLive - Visits Every Allocated PCB
+ *
+ *  The successor of each PCB is fetched before it is visited, 
+ *  so `visit` may free the PCB it is given (e.g. at shutdown).
+ *
+ *  Parameters:
+ *    - visit: Function called on each allocated PCB.
+ *    - arg:   Argument passed to each `visit` call.
+ ***************************************************************/
+void walkLive(pcbVisit_t visit, void *arg) {
+	pcb_PTR p, next;
+	STAT_ENTER(ST_WALKLIVE)
+
+	for (p = pcbLive_h; NULL != p; p = next) {
+		STAT_ITER(ST_WALKLIVE);
+		next = GETPCB(p, p_live_next);
+		visit(p, arg);
+	}
+}
@@ -0,0 +1,293 @@
+/******************************* readyq.c ************************************
+ *
+ *  Module: Multi-Level Ready Queue
+ *
+ *  This module implements a priority ready queue made of `PRIOLEVELS` 
+ *  FIFO process queues, one per priority level. Level 0 is the highest 
+ *  priority, and processes of the same level are served in FIFO order.
+ *
+ *  Data Structures Used:
+ *  
+ *  - Queue: Each level is an ordinary process queue (tail pointer into a 
+ *    circular doubly linked list) managed with the procQ primitives of 
+ *    `pcb.c`.
+ *  - Bitmap: `rq_bitmap` has bit i set exactly when level i is non-empty, 
+ *    so the highest non-empty level is found with one find-first-set.
+ *
+ *  This module ensures:
+ *  
+ *  - Optionally (`PHASE1_ACCT`), a wait histogram per level (`rq_hist`); 
+ *    a priority change ends one wait and starts another.
+ *  - Constant time insertion (`insertReadyQ`), removal of the highest 
+ *    priority process (`removeReadyQ`), removal of a given process 
+ *    (`outReadyQ`) and priority change (`setPriority`; O(log n) 
+ *    amortized for a waiter of a priority ordered semaphore queue).
+ *  - Optionally (`PHASE1_SMP`), one ready queue per processor 
+ *    (`cpuReadyQ`), each guarded by its own lock (`rq_lock`) so that 
+ *    processors schedule without contending. A processor whose queue 
+ *    runs dry steals from the others (`stealReadyQ`, `nextReady`): it 
+ *    takes the tail of a victim's highest non-empty level, the process 
+ *    that victim would have run last.
+ *
+ *****************************************************************************/
+
+#include "../h/readyq.h"
+#include "../h/pcb.h"
+#include "../h/asl.h"
+#include "../h/bitmap.h"
+#include "../h/acct.h"
+#include "../h/spin.h"
+#include "../h/port.h"
+
+#ifdef PHASE1_SMP
+readyq_t cpuReadyQ[NCPU];	/* Ready queue of each processor */
+#endif
+
+/***************************************************************
+ *  initReadyQ - Initializes a Multi-Level Ready Queue
+ *
+ *  Parameters:
+ *    - rq: Pointer to the ready queue.
+ ***************************************************************/
+void initReadyQ(readyq_PTR rq) {
+	int i;
+
+	rq->rq_bitmap = 0;	/* No level holds a process */
+	for (i = 0; i < PRIOLEVELS; ++i) {
+		rq->rq_tail[i] = mkEmptyProcQ();
+#ifdef PHASE1_ACCT
+		resetHist(&(rq->rq_hist[i]));
+#endif
+	}
+	INITLOCK(&(rq->rq_lock));
+}
+
+/***************************************************************
+ *  emptyReadyQ - Checks if a Ready Queue is Empty
+ *
+ *  Parameters:
+ *    - rq: Pointer to the ready queue.
+ *
+ *  Returns:
+ *    - 1 (TRUE) if no level holds a process.
+ *    - 0 (FALSE) otherwise.
+ ***************************************************************/
+int emptyReadyQ(readyq_PTR rq) {
+	return (0 == rq->rq_bitmap);
+}
+
+/***************************************************************
+ *  queueIn - insertReadyQ, for a Non-NULL PCB, Lock Held
+ ***************************************************************/
+static void queueIn(readyq_PTR rq, pcb_PTR p) {
+	insertProcQUnchecked(&(rq->rq_tail[p->p_prio]), p);
+	rq->rq_bitmap |= (1U << p->p_prio);		/* Level is now non-empty */
+}
+
+/***************************************************************
+ *  queueOut - outReadyQ, Lock Held
+ ***************************************************************/
+static pcb_PTR queueOut(readyq_PTR rq, pcb_PTR p) {
+	pcb_PTR pcbRm;
+	int level;
+
+	/* Ignore NULL process, and processes not queued on a level of rq */
+	if (NULL == p || p->p_queue < rq->rq_tail || p->p_queue >= rq->rq_tail + PRIOLEVELS)
+		return NULL;
+
+	/* The level is the one p is queued on, which is p_prio only as 
+	 * long as p_prio has not been changed behind the queue's back */
+	level = p->p_queue - rq->rq_tail;
+
+	pcbRm = outProcQUnchecked(&(rq->rq_tail[level]), p);
+	ACCT_RECORD(&(rq->rq_hist[level]), p);
+
+	/* Clear the level's bit once it becomes empty */
+	if (emptyProcQ(rq->rq_tail[level]))
+		rq->rq_bitmap &= ~(1U << level);
+
+	return pcbRm;
+}
+
+/***************************************************************
+ *  queueHead - headReadyQ, Lock Held
+ ***************************************************************/
+static pcb_PTR queueHead(readyq_PTR rq) {
+	/* Return NULL if the ready queue is empty */
+	if (emptyReadyQ(rq)) return NULL;
+
+	return headProcQ(rq->rq_tail[firstSetBit(rq->rq_bitmap)]);
+}
+
+/***************************************************************
+ *  insertReadyQ - Inserts a PCB at the Tail of its Level
+ *
+ *  The level is the PCB's priority (`p_prio`).
+ *
+ *  Parameters:
+ *    - rq: Pointer to the ready queue.
+ *    - p:  PCB to be inserted.
+ ***************************************************************/
+void insertReadyQ(readyq_PTR rq, pcb_PTR p) {
+	/* Ignore NULL process */
+	if (NULL == p) return;
+
+	LOCK(&(rq->rq_lock));
+	queueIn(rq, p);
+	UNLOCK(&(rq->rq_lock));
+}
+
+/***************************************************************
+ *  outReadyQ - Removes a Specific PCB from the Ready Queue
+ *
+ *  Parameters:
+ *    - rq: Pointer to the ready queue.
+ *    - p:  PCB to be removed.
+ *
+ *  Returns:
+ *    - Pointer to the removed PCB.
+ *    - NULL if `p` is NULL or not in `rq`.
+ ***************************************************************/
+pcb_PTR outReadyQ(readyq_PTR rq, pcb_PTR p) {
+	LOCK(&(rq->rq_lock));
+	p = queueOut(rq, p);
+	UNLOCK(&(rq->rq_lock));
+
+	return p;
+}
+
+/***************************************************************
+ *  removeReadyQ - Removes the Highest Priority PCB
+ *
+ *  Parameters:
+ *    - rq: Pointer to the ready queue.
+ *
+ *  Returns:
+ *    - Pointer to the head of the highest non-empty level.
+ *    - NULL if the ready queue is empty.
+ ***************************************************************/
+pcb_PTR removeReadyQ(readyq_PTR rq) {
+	pcb_PTR p;
+
+	LOCK(&(rq->rq_lock));
+	p = queueOut(rq, queueHead(rq));
+	UNLOCK(&(rq->rq_lock));
+
+	return p;
+}
+
+/***************************************************************
+ *  headReadyQ - Retrieves the Highest Priority PCB
+ *
+ *  Parameters:
+ *    - rq: Pointer to the ready queue.
+ *
+ *  Returns:
+ *    - Pointer to the head of the highest non-empty level 
+ *      (not removed).
+ *    - NULL if the ready queue is empty.
+ ***************************************************************/
+pcb_PTR headReadyQ(readyq_PTR rq) {
+	pcb_PTR p;
+
+	LOCK(&(rq->rq_lock));
+	p = queueHead(rq);
+	UNLOCK(&(rq->rq_lock));
+
+	return p;
+}
+
+/***************************************************************
+ *  setPriority - Changes the Priority of a PCB
+ *
+ *  If `p` is in `rq`, it is moved to the tail of its new level; 
+ *  if it is blocked on a semaphore, `setBlockedPrio` updates it, 
+ *  moving it if it waits in a priority ordered queue. Otherwise 
+ *  only `p_prio` changes: a PCB queued elsewhere still leaves its 
+ *  queue from the level it was inserted at. Priorities outside [HIGHPRIO, LOWPRIO] are clamped to 
+ *  that range.
+ *
+ *  Parameters:
+ *    - rq:   Pointer to the ready queue.
+ *    - p:    PCB whose priority changes.
+ *    - prio: New priority.
+ ***************************************************************/
+void setPriority(readyq_PTR rq, pcb_PTR p, int prio) {
+	/* Ignore NULL process */
+	if (NULL == p) return;
+
+	prio = MAX(HIGHPRIO, MIN(prio, LOWPRIO));
+
+	LOCK(&(rq->rq_lock));
+
+	/* Requeue only if p is currently in rq */
+	if (NULL != queueOut(rq, p)) {
+		p->p_prio = prio;
+		queueIn(rq, p);
+		UNLOCK(&(rq->rq_lock));
+		return;
+	}
+
+	UNLOCK(&(rq->rq_lock));
+
+	if (NULL != p->p_semAdd)
+		setBlockedPrio(p, prio);
+	else
+		p->p_prio = prio;
+}
+
+/***************************************************************
+ *  stealReadyQ - Takes a PCB from Another Processor's Queue
+ *
+ *  The victims are tried in order, starting after `self`. Each one 
+ *  is first checked without its lock, so empty queues cost no lock 
+ *  traffic; the first non-empty one gives up the tail of its 
+ *  highest non-empty level.
+ *
+ *  Parameters:
+ *    - rqs:  Array of the ready queues of the processors.
+ *    - ncpu: Number of ready queues in `rqs`.
+ *    - self: Index of the caller's own queue, which is skipped.
+ *
+ *  Returns:
+ *    - Pointer to the stolen PCB, no longer in any queue.
+ *    - NULL if every other queue is empty.
+ ***************************************************************/
+pcb_PTR stealReadyQ(readyq_t rqs[], int ncpu, int self) {
+	readyq_PTR victim;
+	pcb_PTR p = NULL;
+	int i;
+
+	for (i = 1; i < ncpu && NULL == p; ++i) {
+		victim = &rqs[(self + i) % ncpu];
+		if (emptyReadyQ(victim)) continue;
+
+		/* Check again under the lock: the owner may have emptied it */
+		LOCK(&(victim->rq_lock));
+		if (!emptyReadyQ(victim))
+			p = queueOut(victim, victim->rq_tail[firstSetBit(victim->rq_bitmap)]);
+		UNLOCK(&(victim->rq_lock));
+	}
+
+	return p;
+}
+
+#ifdef PHASE1_SMP
+/***************************************************************
+ *  nextReady - Picks the Next Process for this Processor
+ *
+ *  Returns:
+ *    - The highest priority PCB of this processor's queue, or, 
+ *      when it is empty, one stolen from another processor.
+ *    - NULL if every ready queue is empty.
+ ***************************************************************/
+pcb_PTR nextReady(void) {
+	pcb_PTR p;
+
+	p = removeReadyQ(&cpuReadyQ[CPUID()]);
+	if (NULL == p)
+		p = stealReadyQ(cpuReadyQ, NCPU, CPUID());
+
+	return p;
+}
+#endif
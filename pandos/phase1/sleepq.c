@@ -0,0 +1,222 @@
+/******************************* sleepq.c ************************************
+ *
+ *  Module: Sleep Queue (Delta List)
+ *
+ *  This module implements timed sleeps: a sleep queue holds processes 
+ *  ordered by wakeup time, and the interval timer is programmed for the 
+ *  nearest wakeup only, instead of every sleeper waking on each 
+ *  pseudo-clock tick to check its own deadline.
+ *
+ *  Data Structures Used:
+ *  
+ *  - Delta List: The queue is an ordinary process queue (tail pointer 
+ *    into a circular doubly linked list, so `outProcQ` and `removeProcQ` 
+ *    work on it) kept sorted by wakeup time. Each PCB stores in 
+ *    `p_delta` its wakeup time relative to the previous PCB's, and the 
+ *    head's is relative to `sq_stamp`. Advancing time therefore only 
+ *    touches the head, and the PCBs that wake together are the run at 
+ *    the front of the queue.
+ *
+ *  This module ensures:
+ *  
+ *  - Insertion (`insertSleepQ`) costs one step per sleeper that wakes 
+ *    earlier; sleepers with the same wakeup time keep FIFO order.
+ *  - Early removal (`outSleepQ`) costs O(1).
+ *  - Waking (`wakeSleepQ`) costs O(1) plus one step per process woken, 
+ *    and hands the woken processes straight to the caller's queue.
+ *  - Times are in TOD clock units (`STCK`); `armSleepQ` loads the 
+ *    interval timer (`LDIT`) with the time left to the next wakeup; a 
+ *    kernel with other deadlines arms the timer with `armTimers` 
+ *    (`timer.c`) instead, which counts the head of the queue as one.
+ *
+ *****************************************************************************/
+
+#include "../h/sleepq.h"
+#include "../h/pcb.h"
+#include "../h/acct.h"
+#include "../h/trace.h"
+#include "../h/port.h"
+
+/***************************************************************
+ *  initSleepQ - Initializes a Sleep Queue
+ *
+ *  Parameters:
+ *    - sq: Pointer to the sleep queue.
+ ***************************************************************/
+void initSleepQ(sleepq_PTR sq) {
+	sq->sq_tail = mkEmptyProcQ();
+	STCK(sq->sq_stamp);
+}
+
+/***************************************************************
+ *  emptySleepQ - Checks if a Sleep Queue is Empty
+ *
+ *  Parameters:
+ *    - sq: Pointer to the sleep queue.
+ *
+ *  Returns:
+ *    - 1 (TRUE) if no process is sleeping.
+ *    - 0 (FALSE) otherwise.
+ ***************************************************************/
+int emptySleepQ(sleepq_PTR sq) {
+	return emptyProcQ(sq->sq_tail);
+}
+
+/***************************************************************
+ *  insertSleepQ - Puts a Process to Sleep
+ *
+ *  This function inserts `p` so that it wakes `delay` time units 
+ *  from now: the queue is walked from the head, consuming the 
+ *  deltas of the processes that wake no later than `p`, and `p` 
+ *  is linked in before the first one that wakes after it.
+ *
+ *  Parameters:
+ *    - sq:    Pointer to the sleep queue.
+ *    - p:     PCB to put to sleep (in no other queue).
+ *    - delay: Time to sleep; negative delays count as 0.
+ ***************************************************************/
+void insertSleepQ(sleepq_PTR sq, pcb_PTR p, cpu_t delay) {
+	pcb_PTR next;
+	cpu_t now;
+	int wrapped = FALSE;
+
+	/* Ignore NULL process */
+	if (NULL == p) return;
+
+	/* Wakeup time relative to sq_stamp, like the head's delta */
+	STCK(now);
+	p->p_delta = MAX(delay, 0) + (now - sq->sq_stamp);
+
+	/* Case 1: Empty queue, p is the only sleeper */
+	if (emptySleepQ(sq)) {
+		insertProcQUnchecked(&(sq->sq_tail), p);
+		return;
+	}
+
+	/* Skip the sleepers that wake no later than p */
+	next = headProcQ(sq->sq_tail);
+	while (next->p_delta <= p->p_delta) {
+		p->p_delta -= next->p_delta;
+		next = GETPCB(next, p_next);
+		if (next == headProcQ(sq->sq_tail)) {
+			wrapped = TRUE;		/* Everyone was skipped: p is last */
+			break;
+		}
+	}
+
+	/* Case 2: p wakes after everyone, append it at the tail */
+	if (wrapped) {
+		insertProcQUnchecked(&(sq->sq_tail), p);
+		return;
+	}
+
+	/* Case 3: Link p in before next, which now wakes relative to p */
+	next->p_delta -= p->p_delta;
+	SETPCB(p, p_next, next);
+	p->p_prev = next->p_prev;
+	SETPCB(GETPCB(next, p_prev), p_next, p);
+	SETPCB(next, p_prev, p);
+	p->p_queue = &(sq->sq_tail);
+	ACCT_ENQUEUE(p);
+	TRACE_EVENT(TR_ENQUEUE, p, &(sq->sq_tail));	/* As insertProcQUnchecked would */
+}
+
+/***************************************************************
+ *  outSleepQ - Wakes a Specific Process Early
+ *
+ *  The PCB after `p`, if any, takes over `p`'s delta so that 
+ *  its own wakeup time does not change.
+ *
+ *  Parameters:
+ *    - sq: Pointer to the sleep queue.
+ *    - p:  PCB to be removed.
+ *
+ *  Returns:
+ *    - Pointer to the removed PCB.
+ *    - NULL if `p` is not in the sleep queue.
+ ***************************************************************/
+pcb_PTR outSleepQ(sleepq_PTR sq, pcb_PTR p) {
+	/* Ignore PCBs that are not sleeping here */
+	if (NULL == p || p->p_queue != &(sq->sq_tail)) return NULL;
+
+	if (p != sq->sq_tail)
+		GETPCB(p, p_next)->p_delta += p->p_delta;
+
+	return outProcQUnchecked(&(sq->sq_tail), p);
+}
+
+/***************************************************************
+ *  wakeSleepQ - Wakes Every Process Whose Wakeup Time Has Come
+ *
+ *  This function charges the time elapsed since `sq_stamp` to the 
+ *  head's delta, then moves the run of PCBs at the front of the 
+ *  queue whose delta is used up to the tail of the queue `tp` 
+ *  (e.g. a ready queue level). What a woken PCB overslept is 
+ *  carried to the next one's delta.
+ *
+ *  Parameters:
+ *    - sq: Pointer to the sleep queue.
+ *    - tp: Pointer to the tail of the queue receiving the woken 
+ *          PCBs, in wakeup order.
+ *
+ *  Returns:
+ *    - The number of processes woken.
+ ***************************************************************/
+int wakeSleepQ(sleepq_PTR sq, pcb_PTR *tp) {
+	pcb_PTR p;
+	cpu_t now;
+	int n = 0;
+
+	/* Charge the elapsed time to the head */
+	STCK(now);
+	if (!emptySleepQ(sq))
+		headProcQ(sq->sq_tail)->p_delta -= (now - sq->sq_stamp);
+	sq->sq_stamp = now;
+
+	/* Move the run of due sleepers, carrying each overshoot */
+	while (!emptySleepQ(sq) && headProcQ(sq->sq_tail)->p_delta <= 0) {
+		p = outProcQUnchecked(&(sq->sq_tail), headProcQ(sq->sq_tail));
+		if (!emptySleepQ(sq))
+			headProcQ(sq->sq_tail)->p_delta += p->p_delta;
+		p->p_delta = 0;
+		insertProcQUnchecked(tp, p);
+		n++;
+	}
+
+	return n;
+}
+
+/***************************************************************
+ *  nextWakeup - Returns the Time Left to the Next Wakeup
+ *
+ *  Parameters:
+ *    - sq: Pointer to the sleep queue.
+ *
+ *  Returns:
+ *    - Time until the head of the queue is due, 0 if it is 
+ *      already due.
+ *    - MAX_INT if no process is sleeping.
+ ***************************************************************/
+cpu_t nextWakeup(sleepq_PTR sq) {
+	cpu_t now;
+
+	if (emptySleepQ(sq)) return MAX_INT;
+
+	STCK(now);
+	return MAX(headProcQ(sq->sq_tail)->p_delta - (now - sq->sq_stamp), 0);
+}
+
+/***************************************************************
+ *  armSleepQ - Programs the Interval Timer for the Next Wakeup
+ *
+ *  Loads the interval timer with `nextWakeup(sq)`, so that its 
+ *  interrupt comes exactly when `wakeSleepQ` has work to do. An 
+ *  empty queue leaves the timer alone.
+ *
+ *  Parameters:
+ *    - sq: Pointer to the sleep queue.
+ ***************************************************************/
+void armSleepQ(sleepq_PTR sq) {
+	if (!emptySleepQ(sq))
+		LDIT(nextWakeup(sq));
+}
@@ -0,0 +1,55 @@
+/******************************** spin.c *************************************
+ *
+ *  Module: Spinlocks
+ *
+ *  This module implements the spinlocks of the multiprocessor 
+ *  configuration (`PHASE1_SMP`, see `h/spin.h`) on the uMPS3 atomic 
+ *  compare and swap service (`CAS`).
+ *
+ *  - A lock is a word: 0 when free, 1 when held.
+ *  - Waiters spin on plain reads of the word and only retry the CAS 
+ *    once it reads free, so a held lock does not keep the bus busy 
+ *    with atomic operations.
+ *  - The locks are not reentrant and do not mask interrupts: the 
+ *    kernel takes them with interrupts disabled.
+ *
+ *****************************************************************************/
+
+#include "../h/spin.h"
+#include "../h/port.h"
+
+#ifdef PHASE1_SMP
+
+/***************************************************************
+ *  initLock - Initializes a Spinlock as Free
+ *
+ *  Parameters:
+ *    - l: Pointer to the lock.
+ ***************************************************************/
+void initLock(spinlock_t *l) {
+	*l = 0;
+}
+
+/***************************************************************
+ *  spinLock - Acquires a Spinlock
+ *
+ *  Parameters:
+ *    - l: Pointer to the lock.
+ ***************************************************************/
+void spinLock(spinlock_t *l) {
+	while (!CAS((unsigned int *) l, 0, 1))
+		while (0 != *l)
+			;		/* Wait for a release before the next CAS */
+}
+
+/***************************************************************
+ *  spinUnlock - Releases a Spinlock
+ *
+ *  Parameters:
+ *    - l: Pointer to the lock, held by the caller.
+ ***************************************************************/
+void spinUnlock(spinlock_t *l) {
+	*l = 0;
+}
+
+#endif
@@ -0,0 +1,183 @@
+/******************************* stats.c *************************************
+ *
+ *  Module: Phase 1 Instrumentation
+ *
+ *  This module keeps the per-operation counters of the PCB and ASL 
+ *  modules when they are built with `PHASE1_STATS` (see `h/stats.h`):
+ *  number of calls, loop iterations and elapsed TOD time (`STCK`), both 
+ *  total and worst case.
+ *
+ *  The counters live in `phase1Stats`, which the kernel may read at any 
+ *  time; `dumpStats` formats them as text lines for a terminal.
+ *
+ *  Without `PHASE1_STATS`, `resetStats` and `dumpStats` do nothing and 
+ *  no counters are kept.
+ *
+ *  The text formatting helpers of every dump function and test program 
+ *  (see `h/fmt.h`) live here too, and are built in every configuration.
+ *
+ *****************************************************************************/
+
+#include "../h/stats.h"
+#include "../h/fmt.h"
+#include "../h/port.h"
+
+#ifdef PHASE1_STATS
+
+phase1stats_t phase1Stats;			/* Counters of every operation */
+
+/* Names of the operations, indexed by their ST_ constants */
+HIDDEN char *statNames[STATOPS] = {
+	"initPcbs", "freePcb", "allocPcb", "allocPcbBatch", "freePcbBatch",
+	"pcbToHandle", "handleToPcb", "mkEmptyProcQ", "emptyProcQ", "insertProcQ",
+	"removeProcQ", "outProcQ", "headProcQ", "unblockProcQ", "emptyChild",
+	"insertChild", "removeChild", "outChild", "adoptChildren", "childCount",
+	"walkSubtree", "outSubtree", "firstLive", "nextLive", "liveCount",
+	"walkLive", "traverseASL", "insertBlocked", "insertBlockedPrio", "removeBlocked",
+	"outBlocked", "headBlocked", "removeAllBlocked", "setBlockedPrio", "registerDevSems",
+	"initASL"
+};
+
+/***************************************************************
+ *  statEnter - Opens an Instrumented Call
+ *
+ *  Parameters:
+ *    - op: Operation being called (ST_ constant).
+ *
+ *  Returns:
+ *    - Frame to be closed by `statLeave`.
+ ***************************************************************/
+statframe_t statEnter(int op) {
+	statframe_t f;
+
+	phase1Stats.st_op[op].os_calls++;
+	f.sf_op = op;
+	STCK(f.sf_start);
+
+	return f;
+}
+
+/***************************************************************
+ *  statLeave - Closes an Instrumented Call
+ *
+ *  Called automatically when the frame opened by `STAT_ENTER` 
+ *  goes out of scope; adds the elapsed time to the operation.
+ *
+ *  Parameters:
+ *    - f: Frame returned by `statEnter`.
+ ***************************************************************/
+void statLeave(statframe_t *f) {
+	cpu_t now;
+	opstat_t *os;
+
+	STCK(now);
+	os = &(phase1Stats.st_op[f->sf_op]);
+	os->os_ticks += now - f->sf_start;
+	os->os_maxTicks = MAX(os->os_maxTicks, now - f->sf_start);
+}
+
+#endif
+
+/***************************************************************
+ *  fmtuint - Writes an Unsigned Decimal Number
+ *
+ *  Returns:
+ *    - Pointer to the character after the number.
+ ***************************************************************/
+char *fmtuint(char *buf, unsigned int v) {
+	char digits[12];
+	int n = 0;
+
+	do {
+		digits[n++] = '0' + (v % 10);
+		v /= 10;
+	} while (v > 0);
+	while (n > 0)
+		*buf++ = digits[--n];
+
+	return buf;
+}
+
+/***************************************************************
+ *  fmthex - Writes an Unsigned Hexadecimal Number of 8 Digits
+ *
+ *  Returns:
+ *    - Pointer to the character after the number.
+ ***************************************************************/
+char *fmthex(char *buf, unsigned int v) {
+	int i;
+
+	for (i = 28; i >= 0; i -= 4)
+		*buf++ = "0123456789abcdef"[(v >> i) & 0xF];
+
+	return buf;
+}
+
+/***************************************************************
+ *  fmtstr - Copies an EOS-terminated String, without the EOS
+ *
+ *  Returns:
+ *    - Pointer to the character after the copy.
+ ***************************************************************/
+char *fmtstr(char *buf, char *str) {
+	while (*str != EOS)
+		*buf++ = *str++;
+
+	return buf;
+}
+
+/***************************************************************
+ *  resetStats - Clears Every Counter
+ ***************************************************************/
+void resetStats(void) {
+#ifdef PHASE1_STATS
+	int i;
+
+	for (i = 0; i < STATOPS; ++i) {
+		phase1Stats.st_op[i].os_calls = phase1Stats.st_op[i].os_iters = 0;
+		phase1Stats.st_op[i].os_ticks = phase1Stats.st_op[i].os_maxTicks = 0;
+	}
+#endif
+}
+
+/***************************************************************
+ *  dumpStats - Prints Every Counter
+ *
+ *  This function formats one line per operation that was called 
+ *  at least once, in the form
+ *
+ *      stat,name,calls,iters,ticks,maxticks
+ *
+ *  and passes each line to `print` (e.g., a terminal writer).
+ *
+ *  Parameters:
+ *    - print: Function receiving each EOS-terminated line.
+ ***************************************************************/
+void dumpStats(void (*print)(char *)) {
+#ifdef PHASE1_STATS
+	int i;
+	char line[96];
+	char *lp;
+	opstat_t *os;
+
+	for (i = 0; i < STATOPS; ++i) {
+		os = &(phase1Stats.st_op[i]);
+		if (0 == os->os_calls) continue;
+
+		lp = fmtstr(line, "stat,");
+		lp = fmtstr(lp, statNames[i]);
+		*lp++ = ',';
+		lp = fmtuint(lp, os->os_calls);
+		*lp++ = ',';
+		lp = fmtuint(lp, os->os_iters);
+		*lp++ = ',';
+		lp = fmtuint(lp, (unsigned int) os->os_ticks);
+		*lp++ = ',';
+		lp = fmtuint(lp, (unsigned int) os->os_maxTicks);
+		*lp++ = '\n';
+		*lp = EOS;
+
+		print(line);
+	}
+#endif
+}
@@ -0,0 +1,217 @@
+/******************************* termout.c ***********************************
+ *
+ *  Module: Buffered Terminal Output
+ *
+ *  This module replaces the busy-waiting `termprint` loops of the test
+ *  programs with buffered, interrupt-driven output on the terminal
+ *  transmitters (see `h/termout.h`).
+ *
+ *  Data Structures Used:
+ *
+ *  - Ring: Each terminal has a ring of `TERMBUFSIZE` characters
+ *    (`termOut`). `to_tail` counts the characters appended and `to_head`
+ *    those handed to the device, so `to_tail - to_head` are waiting.
+ *
+ *  This module ensures:
+ *
+ *  - Writers (`termWrite`) only copy their string into the ring and, if
+ *    the transmitter is idle, hand it the first character; they wait
+ *    for the device only when the ring is full.
+ *  - Each transmit-complete interrupt (`termInterrupt`) acknowledges the
+ *    device by handing it the next character, or with an ACK when the
+ *    ring is empty. Programs that take no interrupts, like the phase 1
+ *    tests, move the output along with `termPoll`.
+ *  - `termFlush` sends everything buffered before returning, for panic
+ *    and halt paths.
+ *  - A transmitter error discards the output buffered for that terminal
+ *    and is reported by every later `termWrite` and `termFlush`.
+ *
+ *  The rings are not locked: writers and the handler of a terminal must
+ *  not run at the same time, as in a kernel that runs with interrupts
+ *  masked. With `PHASE1_HOST`, every transmitter is stdout and completes
+ *  each character at once.
+ *
+ *****************************************************************************/
+
+#include "../h/termout.h"
+#include "../h/port.h"
+
+#if (TERMBUFSIZE & (TERMBUFSIZE - 1)) != 0
+#error "TERMBUFSIZE must be a power of 2"
+#endif
+
+HIDDEN termout_t termOut[DEVPERINT];	/* Output state of each terminal */
+
+#ifdef PHASE1_HOST
+
+/* host build: the transmitters write to stdout and are never busy */
+static unsigned int txStatus(int term) {
+	return TRANSMITTED;
+}
+
+static void txSend(int term, char c) {
+	char str[2];
+
+	str[0] = c;
+	str[1] = EOS;
+	hostPrint(str);
+}
+
+static void txAck(int term) {
+}
+
+#else
+
+/* Device register of the transmitter of terminal T */
+#define TERMREG(T)	(&(((volatile devregarea_t *) RAMBASEADDR)->devreg[(TERMINT - DISKINT) * DEVPERINT + (T)]))
+
+/***************************************************************
+ *  txStatus - Reads the Status Code of a Transmitter
+ ***************************************************************/
+static unsigned int txStatus(int term) {
+	return TERMREG(term)->t_transm_status & STATUSMASK;
+}
+
+/***************************************************************
+ *  txSend - Starts the Transmission of a Character
+ ***************************************************************/
+static void txSend(int term, char c) {
+	TERMREG(term)->t_transm_command = ((unsigned int) (unsigned char) c << CHAROFFSET) | PRINTCHR;
+}
+
+/***************************************************************
+ *  txAck - Acknowledges a Transmitter Interrupt
+ ***************************************************************/
+static void txAck(int term) {
+	TERMREG(term)->t_transm_command = ACK;
+}
+
+#endif
+
+/***************************************************************
+ *  startTx - Hands an Idle Transmitter its Next Character
+ *
+ *  Parameters:
+ *    - to:   Output state of the terminal.
+ *    - term: Number of the terminal.
+ ***************************************************************/
+static void startTx(termout_t *to, int term) {
+	if (to->to_busy || to->to_head == to->to_tail) return;
+
+	txSend(term, to->to_buf[to->to_head++ & (TERMBUFSIZE - 1)]);
+	to->to_busy = TRUE;
+}
+
+/***************************************************************
+ *  initTermOut - Empties the Ring of Every Terminal
+ ***************************************************************/
+void initTermOut(void) {
+	int i;
+
+	for (i = 0; i < DEVPERINT; ++i) {
+		termOut[i].to_head = termOut[i].to_tail = 0;
+		termOut[i].to_busy = termOut[i].to_error = FALSE;
+	}
+}
+
+/***************************************************************
+ *  termWrite - Queues a String for Output
+ *
+ *  The string is copied into the terminal's ring, and its first
+ *  character is handed to the transmitter if it is idle. Only a
+ *  full ring makes the caller wait for the device.
+ *
+ *  Parameters:
+ *    - term: Number of the terminal (0 to DEVPERINT - 1).
+ *    - str:  EOS-terminated string.
+ *
+ *  Returns:
+ *    - 1 (TRUE) if the string was queued.
+ *    - 0 (FALSE) if `term` is not a terminal, or its transmitter
+ *      failed.
+ ***************************************************************/
+int termWrite(int term, char *str) {
+	termout_t *to;
+
+	if (term < 0 || term >= DEVPERINT) return FALSE;
+	to = &termOut[term];
+
+	for (; EOS != *str; ++str) {
+		/* A full ring is drained by the device first */
+		while (TERMBUFSIZE == to->to_tail - to->to_head) {
+			startTx(to, term);
+			termPoll(term);
+		}
+		to->to_buf[to->to_tail++ & (TERMBUFSIZE - 1)] = *str;
+	}
+	startTx(to, term);
+
+	return !to->to_error;
+}
+
+/***************************************************************
+ *  termInterrupt - Handles a Transmit-Complete Interrupt
+ *
+ *  Called by the interrupt handler for the transmitter of `term`.
+ *  A successful transmission is followed by the next buffered
+ *  character, which also acknowledges the interrupt; a failed one
+ *  discards the buffered output.
+ *
+ *  Parameters:
+ *    - term: Number of the terminal.
+ ***************************************************************/
+void termInterrupt(int term) {
+	termout_t *to = &termOut[term];
+
+	if (to->to_busy && TRANSMITTED != txStatus(term)) {
+		to->to_error = TRUE;
+		to->to_head = to->to_tail;
+	}
+	to->to_busy = FALSE;
+
+	if (to->to_head == to->to_tail)
+		txAck(term);
+	else
+		startTx(to, term);
+}
+
+/***************************************************************
+ *  termPoll - Moves the Output Along without Interrupts
+ *
+ *  Runs the interrupt handler of `term` if the character in
+ *  flight has been transmitted.
+ *
+ *  Parameters:
+ *    - term: Number of the terminal.
+ ***************************************************************/
+void termPoll(int term) {
+	if (termOut[term].to_busy && BUSY != txStatus(term))
+		termInterrupt(term);
+}
+
+/***************************************************************
+ *  termFlush - Sends all the Buffered Output of a Terminal
+ *
+ *  Waits, polling the device, until the ring is empty and the
+ *  last character has been transmitted.
+ *
+ *  Parameters:
+ *    - term: Number of the terminal.
+ *
+ *  Returns:
+ *    - 1 (TRUE) if all the output was transmitted.
+ *    - 0 (FALSE) if `term` is not a terminal, or its transmitter
+ *      failed.
+ ***************************************************************/
+int termFlush(int term) {
+	termout_t *to;
+
+	if (term < 0 || term >= DEVPERINT) return FALSE;
+	to = &termOut[term];
+
+	startTx(to, term);
+	while (to->to_busy)
+		termPoll(term);
+
+	return !to->to_error;
+}
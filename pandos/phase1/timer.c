@@ -0,0 +1,231 @@
+/******************************** timer.c ************************************
+ *
+ *  Module: Timer Events
+ *
+ *  This module multiplexes the deadlines of the scheduler on the one 
+ *  interval timer, so that the timer only interrupts when something is 
+ *  actually due (see `h/timer.h`), instead of on every quantum and on 
+ *  every pseudo-clock tick.
+ *
+ *  The deadlines of a `timers_t` are:
+ *  
+ *  - the end of the running quantum (`startQuantum`, `stopQuantum`);
+ *  - the head of a sleep queue (see `sleepq.c`);
+ *  - the next pseudo-clock tick, every `PSECOND`, counted only while 
+ *    a process is blocked on the pseudo-clock semaphore. Ticks keep 
+ *    their phase: the ones that go by with nobody waiting are skipped 
+ *    without an interrupt.
+ *
+ *  This module ensures:
+ *  
+ *  - `armTimers` loads the timer (`LDIT`) with the time left to the 
+ *    nearest deadline, and only when that deadline changed since it 
+ *    was last loaded. With no deadline at all (a fully idle system) 
+ *    the timer is parked once (`DISARMIT`) and left alone.
+ *  - `dueTimers`, called by the interval timer interrupt handler, 
+ *    returns the events that have come (`TM_QUANTUM`, `TM_SLEEP`, 
+ *    `TM_CLOCK`); the handler serves them and then calls `armTimers`, 
+ *    which also acknowledges the interrupt.
+ *
+ *  Times are TOD clock values (`STCK`), compared by difference so that 
+ *  the wrap of the clock does not matter.
+ *
+ *****************************************************************************/
+
+#include "../h/timer.h"
+#include "../h/sleepq.h"
+#include "../h/asl.h"
+#include "../h/pcb.h"
+#include "../h/port.h"
+
+/***************************************************************
+ *  catchUpTick - Moves the Next Tick Past the Current Time
+ *
+ *  Parameters:
+ *    - tm:  Pointer to the timer events.
+ *    - now: Current TOD.
+ ***************************************************************/
+static void catchUpTick(timers_PTR tm, cpu_t now) {
+	if (tm->tm_tick - now <= 0)
+		tm->tm_tick += ((now - tm->tm_tick) / PSECOND + 1) * PSECOND;
+}
+
+/***************************************************************
+ *  nearestDeadline - Finds the Nearest Pending Deadline
+ *
+ *  Parameters:
+ *    - tm:  Pointer to the timer events.
+ *    - now: Current TOD.
+ *    - at:  Receives the TOD of the nearest deadline, `now` if 
+ *           there is none.
+ *
+ *  Returns:
+ *    - 1 (TRUE) if there is a deadline.
+ *    - 0 (FALSE) if nothing waits for time.
+ ***************************************************************/
+static int nearestDeadline(timers_PTR tm, cpu_t now, cpu_t *at) {
+	int found = FALSE;
+	cpu_t t;
+
+	*at = now;
+	if (tm->tm_active & TM_QUANTUM) {
+		*at = tm->tm_quantum;
+		found = TRUE;
+	}
+
+	/* The head sleeper wakes p_delta after the queue's stamp */
+	if (NULL != tm->tm_sleepq && !emptySleepQ(tm->tm_sleepq)) {
+		t = tm->tm_sleepq->sq_stamp + headProcQ(tm->tm_sleepq->sq_tail)->p_delta;
+		if (!found || t - now < *at - now)
+			*at = t;
+		found = TRUE;
+	}
+
+	/* Ticks nobody waits for are skipped */
+	if (NULL != tm->tm_clockSem && NULL != headBlocked(tm->tm_clockSem)) {
+		if (!found || tm->tm_tick - now < *at - now)
+			*at = tm->tm_tick;
+		found = TRUE;
+	} else
+		catchUpTick(tm, now);
+
+	return found;
+}
+
+/***************************************************************
+ *  initTimers - Initializes the Timer Events
+ *
+ *  No quantum runs, the first tick is `PSECOND` from now, and 
+ *  the interval timer is parked.
+ *
+ *  Parameters:
+ *    - tm:       Pointer to the timer events.
+ *    - sq:       Sleep queue whose head is a deadline, or NULL.
+ *    - clockSem: Pseudo-clock semaphore, or NULL for no ticks.
+ ***************************************************************/
+void initTimers(timers_PTR tm, sleepq_PTR sq, int *clockSem) {
+	cpu_t now;
+
+	STCK(now);
+	tm->tm_sleepq = sq;
+	tm->tm_clockSem = clockSem;
+	tm->tm_quantum = tm->tm_armed = now;
+	tm->tm_tick = now + PSECOND;
+
+	DISARMIT();
+	tm->tm_active = TM_PARKED;
+}
+
+/***************************************************************
+ *  startQuantum - Starts the Quantum of a Dispatched Process
+ *
+ *  Parameters:
+ *    - tm:  Pointer to the timer events.
+ *    - len: Length of the quantum (e.g. TIMESLICE).
+ ***************************************************************/
+void startQuantum(timers_PTR tm, cpu_t len) {
+	cpu_t now;
+
+	STCK(now);
+	tm->tm_quantum = now + MAX(len, 0);
+	tm->tm_active |= TM_QUANTUM;
+}
+
+/***************************************************************
+ *  stopQuantum - Ends the Quantum Early
+ *
+ *  For a process that blocks or terminates, or an idle processor.
+ *
+ *  Parameters:
+ *    - tm: Pointer to the timer events.
+ ***************************************************************/
+void stopQuantum(timers_PTR tm) {
+	tm->tm_active &= ~TM_QUANTUM;
+}
+
+/***************************************************************
+ *  nextDeadline - Returns the Time Left to the Nearest Deadline
+ *
+ *  Parameters:
+ *    - tm: Pointer to the timer events.
+ *
+ *  Returns:
+ *    - Time until the nearest deadline, 0 if it is already due.
+ *    - MAX_INT if nothing waits for time.
+ ***************************************************************/
+cpu_t nextDeadline(timers_PTR tm) {
+	cpu_t now, at;
+
+	STCK(now);
+	if (!nearestDeadline(tm, now, &at)) return MAX_INT;
+
+	return MAX(at - now, 0);
+}
+
+/***************************************************************
+ *  dueTimers - Collects the Events that Have Come
+ *
+ *  Called on an interval timer interrupt. A quantum that is 
+ *  over is stopped, and a tick that went by moves the next 
+ *  one on; the handler must call `armTimers` afterwards.
+ *
+ *  Parameters:
+ *    - tm: Pointer to the timer events.
+ *
+ *  Returns:
+ *    - The TM_QUANTUM, TM_SLEEP and TM_CLOCK bits of the events 
+ *      that are due, 0 for none.
+ ***************************************************************/
+int dueTimers(timers_PTR tm) {
+	cpu_t now;
+	int due = 0;
+
+	STCK(now);
+
+	/* The interrupt is pending until the timer is loaded again */
+	tm->tm_active &= ~(TM_ARMED | TM_PARKED);
+
+	if ((tm->tm_active & TM_QUANTUM) && tm->tm_quantum - now <= 0) {
+		tm->tm_active &= ~TM_QUANTUM;
+		due |= TM_QUANTUM;
+	}
+	if (NULL != tm->tm_sleepq && 0 == nextWakeup(tm->tm_sleepq))
+		due |= TM_SLEEP;
+	if (tm->tm_tick - now <= 0) {
+		catchUpTick(tm, now);
+		due |= TM_CLOCK;
+	}
+
+	return due;
+}
+
+/***************************************************************
+ *  armTimers - Programs the Interval Timer for the Nearest Deadline
+ *
+ *  The timer is loaded only if the nearest deadline is not the 
+ *  one it already counts down to; with no deadline it is parked, 
+ *  unless it already is.
+ *
+ *  Parameters:
+ *    - tm: Pointer to the timer events.
+ ***************************************************************/
+void armTimers(timers_PTR tm) {
+	cpu_t now, at;
+
+	STCK(now);
+
+	/* Fully idle: park the timer once */
+	if (!nearestDeadline(tm, now, &at)) {
+		if (!(tm->tm_active & TM_PARKED)) {
+			DISARMIT();
+			tm->tm_active = (tm->tm_active & ~TM_ARMED) | TM_PARKED;
+		}
+		return;
+	}
+
+	if (!(tm->tm_active & TM_ARMED) || at != tm->tm_armed) {
+		LDIT(MAX(at - now, 0));
+		tm->tm_armed = at;
+		tm->tm_active = (tm->tm_active & ~TM_PARKED) | TM_ARMED;
+	}
+}
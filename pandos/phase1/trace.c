@@ -0,0 +1,133 @@
+/******************************** trace.c ************************************
+ *
+ *  Module: Phase 1 Event Trace
+ *
+ *  This module keeps the event ring of the PCB and ASL modules when
+ *  they are built with `PHASE1_TRACE` (see `h/trace.h`).
+ *
+ *  - Recording an event (`traceEvent`) stores four fields in the next
+ *    slot of `traceRing` and bumps `traceCount`; it never blocks,
+ *    prints or checks anything, so it can sit on the hot paths.
+ *  - `traceCount` counts every event ever recorded, so slot
+ *    `traceCount % TRACESIZE` is the next one to be overwritten and
+ *    the last `TRACESIZE` events are always in the ring.
+ *  - `dumpTrace` drains the events recorded since the previous dump,
+ *    oldest first, as text lines for a terminal, e.g. from a panic
+ *    path; it reports how many were overwritten before it ran.
+ *  - With `PHASE1_SMP`, processors recording at the same time may
+ *    take the same slot: the trace is best effort there.
+ *
+ *  Without `PHASE1_TRACE`, `resetTrace` and `dumpTrace` do nothing and
+ *  no events are kept.
+ *
+ *****************************************************************************/
+
+#include "../h/trace.h"
+#include "../h/fmt.h"
+#include "../h/port.h"
+
+#ifdef PHASE1_TRACE
+
+#if (TRACESIZE & (TRACESIZE - 1)) != 0
+#error "TRACESIZE must be a power of 2"
+#endif
+
+extern pcb_t pcbPool[];
+
+traceev_t traceRing[TRACESIZE];		/* Last TRACESIZE events */
+unsigned int traceCount;			/* Events recorded so far */
+HIDDEN unsigned int traceDumped;	/* Value of traceCount at the last dump */
+
+/* Names of the events, indexed by their TR_ constants */
+HIDDEN char *traceNames[TRACEOPS] = {
+	"alloc", "free", "enqueue", "dequeue", "block", "unblock",
+	"unblockall", "inschild", "outchild", "adopt"
+};
+
+/***************************************************************
+ *  traceEvent - Records an Event in the Ring
+ *
+ *  Parameters:
+ *    - op:   Event (TR_ constant).
+ *    - p:    PCB the event is about, or NULL.
+ *    - addr: Semaphore, queue or parent, depending on `op`.
+ ***************************************************************/
+void traceEvent(int op, pcb_PTR p, void *addr) {
+	traceev_t *e = &traceRing[traceCount++ & (TRACESIZE - 1)];
+
+	STCK(e->te_time);
+	e->te_addr = addr;
+	e->te_pcb = (NULL == p) ? NOLINK : (unsigned short) (p - pcbPool);
+	e->te_op = op;
+}
+
+#endif
+
+/***************************************************************
+ *  resetTrace - Discards Every Recorded Event
+ ***************************************************************/
+void resetTrace(void) {
+#ifdef PHASE1_TRACE
+	traceCount = traceDumped = 0;
+#endif
+}
+
+/***************************************************************
+ *  dumpTrace - Prints the Events Recorded since the Last Dump
+ *
+ *  This function formats one line per event still in the ring,
+ *  oldest first, in the form
+ *
+ *      trace,seq,time,event,pcb,addr
+ *
+ *  (pcb is "-" for none, addr is in hexadecimal), preceded by a
+ *  "trace,lost,n" line if n of them were overwritten, and passes
+ *  each line to `print` (e.g., a terminal writer).
+ *
+ *  Parameters:
+ *    - print: Function receiving each EOS-terminated line.
+ ***************************************************************/
+void dumpTrace(void (*print)(char *)) {
+#ifdef PHASE1_TRACE
+	char line[96];
+	char *lp;
+	unsigned int seq, end;
+	traceev_t *e;
+
+	/* Events older than the last TRACESIZE were overwritten */
+	end = traceCount;
+	seq = traceDumped;
+	if (end - seq > TRACESIZE) {
+		lp = fmtstr(line, "trace,lost,");
+		lp = fmtuint(lp, end - seq - TRACESIZE);
+		*lp++ = '\n';
+		*lp = EOS;
+		print(line);
+		seq = end - TRACESIZE;
+	}
+
+	for (; seq != end; ++seq) {
+		e = &traceRing[seq & (TRACESIZE - 1)];
+
+		lp = fmtstr(line, "trace,");
+		lp = fmtuint(lp, seq);
+		*lp++ = ',';
+		lp = fmtuint(lp, (unsigned int) e->te_time);
+		*lp++ = ',';
+		lp = fmtstr(lp, (e->te_op < TRACEOPS) ? traceNames[e->te_op] : "?");
+		*lp++ = ',';
+		if (NOLINK == e->te_pcb)
+			*lp++ = '-';
+		else
+			lp = fmtuint(lp, e->te_pcb);
+		*lp++ = ',';
+		lp = fmthex(lp, (unsigned int) (unsigned long) e->te_addr);
+		*lp++ = '\n';
+		*lp = EOS;
+
+		print(line);
+	}
+
+	traceDumped = end;
+#endif
+}